@@ -0,0 +1,597 @@
+/**
+ * @file listrev_bench.cxx
+ *
+ * Runs the listrev pipeline (validator, generators and reversers) in a single
+ * process, with the modules' list kernels and data structures connected by
+ * in-process queues, and reports throughput and end-to-end latency. No DAQ
+ * session, configuration database or process manager is needed, so it can be
+ * run directly under perf.
+ *
+ * This is part of the DUNE DAQ Software Suite, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#include "CommonIssues.hpp"
+#include "FaultInjector.hpp"
+#include "LatencyHistogram.hpp"
+#include "ListKernels.hpp"
+#include "ListStorage.hpp"
+#include "ListTransforms.hpp"
+#include "ListWrapper.hpp"
+#include "PendingListTable.hpp"
+#include "RequestWindow.hpp"
+
+#include "iomanager/queue/FollyQueue.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace dunedaq::listrev;
+using dunedaq::iomanager::FollyMPMCQueue;
+using dunedaq::iomanager::FollySPSCQueue;
+
+namespace {
+
+struct Options
+{
+  double rate_hz{ 0 }; ///< 0: as fast as max_outstanding allows
+  int min_list_size{ 50 };
+  int max_list_size{ 200 };
+  size_t generators{ 3 };
+  size_t reversers{ 2 };
+  double duration_s{ 10 };
+  size_t max_outstanding{ 100 };
+  std::chrono::milliseconds timeout{ 1000 };
+  size_t queue_capacity{ 10000 };
+  TransformChain transforms; ///< Empty: reverse, as ListReverser does
+  FaultInjector::Settings faults; ///< Injected where each reverser receives a list
+};
+
+const std::chrono::milliseconds s_poll_timeout{ 1 };
+std::atomic<bool> g_running{ true };
+
+using IntListQueue = FollyMPMCQueue<IntList>;
+using RequestQueue = FollyMPMCQueue<RequestList>;
+using ReversedListQueue = FollyMPMCQueue<ReversedList>;
+using CreateQueue = FollySPSCQueue<CreateList>;
+
+/**
+ * @brief Counterpart of RandomDataListGenerator: one thread fills lists on CreateList, one answers RequestList
+ */
+class Generator
+{
+public:
+  Generator(size_t id, const Options& opts)
+    : m_id(id)
+    , m_mode(list_mode_for_generator(id))
+    , m_timeout(opts.timeout)
+    , m_creates("creates" + std::to_string(id), opts.queue_capacity)
+    , m_requests("generator_requests" + std::to_string(id), opts.queue_capacity)
+  {
+    m_storage.set_capacity(std::max<size_t>(1000, 4 * opts.max_outstanding));
+  }
+
+  void start(std::vector<IntListQueue*> reverser_queues)
+  {
+    m_reverser_queues = std::move(reverser_queues);
+    m_threads.emplace_back(&Generator::create_loop, this);
+    m_threads.emplace_back(&Generator::request_loop, this);
+  }
+  void join()
+  {
+    for (auto& thread : m_threads) {
+      thread.join();
+    }
+  }
+
+  CreateQueue& creates() { return m_creates; }
+  RequestQueue& requests() { return m_requests; }
+  size_t missing() const { return m_missing.load(); }
+
+private:
+  void create_loop()
+  {
+    CreateList create;
+    while (g_running.load(std::memory_order_relaxed)) {
+      if (!m_creates.try_pop(create, s_poll_timeout)) {
+        continue;
+      }
+      std::vector<int> list(create.list_size);
+      fill_list(m_mode, create.list_id, list);
+      m_storage.add_list(IntList(create.list_id, m_id, list), true);
+    }
+  }
+
+  void request_loop()
+  {
+    RequestList request;
+    while (g_running.load(std::memory_order_relaxed)) {
+      if (!m_requests.try_pop(request, s_poll_timeout)) {
+        continue;
+      }
+
+      // Same wait as RandomDataListGenerator::process_request_list, for requests that overtake their CreateList
+      auto start = std::chrono::steady_clock::now();
+      bool list_found = false;
+      while (std::chrono::steady_clock::now() - start < m_timeout) {
+        if (m_storage.has_list(request.list_id)) {
+          list_found = true;
+          break;
+        }
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+      }
+      if (!list_found) {
+        ++m_missing;
+        continue;
+      }
+      auto output = m_storage.get_list(request.list_id);
+      m_reverser_queues[std::stoul(request.destination)]->try_push(std::move(output), m_timeout);
+    }
+  }
+
+  size_t m_id;
+  ListMode m_mode;
+  std::chrono::milliseconds m_timeout;
+  ListStorage m_storage;
+  CreateQueue m_creates;
+  RequestQueue m_requests;
+  std::vector<IntListQueue*> m_reverser_queues;
+  std::vector<std::thread> m_threads;
+  std::atomic<size_t> m_missing{ 0 };
+};
+
+/**
+ * @brief Counterpart of ListReverser: one thread forwards requests to the generators, one assembles reversed lists
+ */
+class Reverser
+{
+public:
+  Reverser(size_t id, const Options& opts)
+    : m_id(id)
+    , m_num_generators(opts.generators)
+    , m_timeout(opts.timeout)
+    , m_transforms(opts.transforms)
+    , m_pending(2 * opts.max_outstanding, opts.generators)
+    , m_requests("reverser_requests" + std::to_string(id), opts.queue_capacity)
+    , m_lists("reverser_lists" + std::to_string(id), opts.queue_capacity)
+  {
+    m_faults.configure(opts.faults, "reverser" + std::to_string(id));
+  }
+
+  void start(std::vector<RequestQueue*> generator_queues, ReversedListQueue* validator_queue)
+  {
+    m_generator_queues = std::move(generator_queues);
+    m_validator_queue = validator_queue;
+    m_threads.emplace_back(&Reverser::request_loop, this);
+    m_threads.emplace_back(&Reverser::list_loop, this);
+  }
+  void join()
+  {
+    for (auto& thread : m_threads) {
+      thread.join();
+    }
+  }
+
+  RequestQueue& requests() { return m_requests; }
+  IntListQueue& lists() { return m_lists; }
+  size_t late() const { return m_late.load(); }
+  bool faults_active() const { return m_faults.active(); }
+  std::string describe_faults() const { return m_faults.describe(); }
+  dunedaq::listrev::opmon::FaultInjectionInfo faults() { return m_faults.generate_opmon_data(); }
+
+private:
+  void request_loop()
+  {
+    RequestList request;
+    auto destination = std::to_string(m_id);
+    while (g_running.load(std::memory_order_relaxed)) {
+      if (!m_requests.try_pop(request, s_poll_timeout)) {
+        continue;
+      }
+      {
+        std::lock_guard<std::mutex> lk(m_mutex);
+        auto [pending, created] = m_pending.insert(request.list_id);
+        if (created) {
+          pending->requestor = request.destination;
+          pending->start_time = std::chrono::steady_clock::now();
+          pending->list.reverser_id = m_id;
+          pending->list.transforms = m_transforms.codes();
+        }
+      }
+      for (auto queue : m_generator_queues) {
+        queue->try_push(RequestList(request.list_id, destination), m_timeout);
+      }
+    }
+  }
+
+  void list_loop()
+  {
+    IntList list;
+    while (g_running.load(std::memory_order_relaxed)) {
+      if (!m_lists.try_pop(list, s_poll_timeout)) {
+        continue;
+      }
+      if (!m_faults.pass()) {
+        continue;
+      }
+
+      ReversedList output;
+      {
+        std::lock_guard<std::mutex> lk(m_mutex);
+        auto pending = m_pending.find(list.list_id);
+        if (pending == nullptr) {
+          ++m_late;
+          continue;
+        }
+        if (pending->has_list_from(list.generator_id)) {
+          continue;
+        }
+        // Generator ids run from 0, so each id is its own slot
+        auto& data = pending->add_list_from(list.generator_id, list.generator_id);
+        if (m_transforms.empty()) {
+          reverse_list(list, m_id, data);
+        } else {
+          m_transforms.apply(list, m_id, data);
+        }
+        if (m_faults.corrupts()) {
+          m_faults.corrupt(data.reversed.list);
+        }
+        if (pending->received_lists < m_num_generators &&
+            std::chrono::steady_clock::now() - pending->start_time <= m_timeout) {
+          continue;
+        }
+        pending->compact();
+        output = std::move(pending->list);
+        m_pending.erase(list.list_id);
+      }
+      m_validator_queue->try_push(std::move(output), m_timeout);
+    }
+  }
+
+  size_t m_id;
+  size_t m_num_generators;
+  std::chrono::milliseconds m_timeout;
+  const TransformChain& m_transforms;
+  PendingListTable m_pending;
+  std::mutex m_mutex;
+  RequestQueue m_requests;
+  IntListQueue m_lists;
+  std::vector<RequestQueue*> m_generator_queues;
+  ReversedListQueue* m_validator_queue{ nullptr };
+  std::vector<std::thread> m_threads;
+  std::atomic<size_t> m_late{ 0 };
+  FaultInjector m_faults;
+};
+
+/**
+ * @brief Counterpart of ReversedListValidator: the calling thread issues requests, one thread validates the results
+ */
+class Validator
+{
+public:
+  explicit Validator(const Options& opts)
+    : m_opts(opts)
+    , m_lists("validator_lists", opts.queue_capacity)
+    , m_size_dist(std::max(opts.min_list_size, 1), std::max(opts.min_list_size, opts.max_list_size))
+  {
+    m_request_window.reset(opts.max_outstanding, 1);
+  }
+
+  void start() { m_thread = std::thread(&Validator::list_loop, this); }
+  void join() { m_thread.join(); }
+
+  ReversedListQueue& lists() { return m_lists; }
+
+  /**
+   * @brief Issue requests for the configured duration, then wait for the outstanding ones to complete or time out
+   * @return Time from the first request until the pipeline drained
+   */
+  std::chrono::steady_clock::duration run(std::vector<Generator*>& generators, std::vector<Reverser*>& reversers)
+  {
+    auto start = std::chrono::steady_clock::now();
+    auto end = start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                         std::chrono::duration<double>(m_opts.duration_s));
+    std::chrono::steady_clock::duration period{ 0 };
+    if (m_opts.rate_hz > 0) {
+      period = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double>(1. / m_opts.rate_hz));
+    }
+
+    auto expire = [&](std::chrono::steady_clock::time_point now) {
+      m_timed_out += m_request_window.expire(now - m_opts.timeout, [](int, size_t) {});
+    };
+
+    int next_id = 0;
+    auto now = start;
+    while (now < end) {
+      expire(now);
+      bool issued = false;
+      while (m_request_window.outstanding() < m_opts.max_outstanding && m_request_window.can_insert(next_id + 1) &&
+             now >= start + period * next_id) {
+        ++next_id;
+        auto size = m_size_dist(m_random_generator);
+        for (auto gen : generators) {
+          gen->creates().try_push(CreateList(next_id, size), m_opts.timeout);
+        }
+        auto reverser = next_id % reversers.size();
+        m_request_window.insert(next_id, reverser, std::chrono::steady_clock::now());
+        reversers[reverser]->requests().try_push(RequestList(next_id, "validator"), m_opts.timeout);
+        ++m_requests;
+        issued = true;
+      }
+      if (!issued) {
+        std::this_thread::sleep_for(std::chrono::microseconds(10));
+      }
+      now = std::chrono::steady_clock::now();
+    }
+
+    // Drain
+    auto drain_end = now + 2 * m_opts.timeout;
+    while (m_request_window.outstanding() > 0 && now < drain_end) {
+      expire(now);
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      now = std::chrono::steady_clock::now();
+    }
+    return now - start;
+  }
+
+  void report(std::chrono::steady_clock::duration elapsed) const
+  {
+    double seconds = std::chrono::duration<double>(elapsed).count();
+    auto us = [&](uint64_t ns) { return ns / 1000.; }; // NOLINT(build/unsigned)
+
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "Requests:    " << m_requests << " issued, " << m_latency.count() << " completed, " << m_timed_out
+              << " timed out, " << m_late_lists << " late, " << m_incomplete << " incomplete\n";
+    std::cout << "Validation:  " << m_valid_pairs << " valid pairs, " << m_invalid_pairs << " invalid pairs\n";
+    std::cout << "Throughput:  " << m_latency.count() / seconds << " list sets/s, " << m_list_count / seconds
+              << " lists/s, " << m_elements / seconds << " elements/s, " << m_bytes / seconds / 1e6 << " MB/s\n";
+    std::cout << "Latency us:  mean " << us(m_latency.mean_ns()) << ", p50 " << us(m_latency.percentile_ns(50))
+              << ", p90 " << us(m_latency.percentile_ns(90)) << ", p99 " << us(m_latency.percentile_ns(99))
+              << ", p99.9 " << us(m_latency.percentile_ns(99.9)) << ", max " << us(m_latency.max_ns()) << "\n";
+  }
+
+private:
+  void list_loop()
+  {
+    ReversedList list;
+    while (g_running.load(std::memory_order_relaxed)) {
+      if (!m_lists.try_pop(list, s_poll_timeout)) {
+        continue;
+      }
+      auto completion = m_request_window.complete(list.list_id, std::chrono::steady_clock::now());
+      if (completion.status == RequestWindow::CompletionStatus::Completed) {
+        m_latency.record(completion.latency);
+      } else if (completion.status == RequestWindow::CompletionStatus::Late) {
+        ++m_late_lists;
+      }
+
+      if (list.lists.size() != m_opts.generators) {
+        ++m_incomplete;
+      }
+      m_list_count += list.lists.size();
+      m_bytes += payload_size(list);
+      for (auto& data : list.lists) {
+        m_elements += data.original.list.size();
+        bool valid = m_opts.transforms.empty() ? is_reversal(data.original, data.reversed)
+                                               : m_opts.transforms.check(data.original.list, data.reversed.list);
+        if (valid) {
+          ++m_valid_pairs;
+        } else {
+          ++m_invalid_pairs;
+        }
+      }
+    }
+  }
+
+  const Options& m_opts;
+  ReversedListQueue m_lists;
+  RequestWindow m_request_window;
+  LatencyHistogram m_latency;
+  std::mt19937 m_random_generator{ std::random_device()() };
+  std::uniform_int_distribution<> m_size_dist;
+  std::thread m_thread;
+
+  // Written by the request thread
+  size_t m_requests{ 0 };
+  size_t m_timed_out{ 0 };
+  // Written by the list thread
+  size_t m_late_lists{ 0 };
+  size_t m_incomplete{ 0 };
+  size_t m_list_count{ 0 };
+  size_t m_elements{ 0 };
+  size_t m_bytes{ 0 };
+  size_t m_valid_pairs{ 0 };
+  size_t m_invalid_pairs{ 0 };
+};
+
+void
+usage(const char* name)
+{
+  std::cout << "Usage: " << name << " [options]\n"
+            << "  --rate HZ              list request rate, 0 for as fast as possible (default 0)\n"
+            << "  --min-size N           minimum list size (default 50)\n"
+            << "  --max-size N           maximum list size (default 200)\n"
+            << "  --generators N         number of generators (default 3)\n"
+            << "  --reversers N          number of reversers (default 2)\n"
+            << "  --duration S           seconds to issue requests for (default 10)\n"
+            << "  --max-outstanding N    maximum outstanding requests (default 100)\n"
+            << "  --timeout-ms MS        request timeout (default 1000)\n"
+            << "  --transforms K1,K2     kernels the reversers apply instead of reversing: reverse, sort,\n"
+            << "                         prefix_sum, minmax, histogram (default: reverse only)\n"
+            << "  --fault-delay-us US    delay added where a reverser receives each list (default 0)\n"
+            << "  --fault-jitter-us US   upper bound of a further random delay per list (default 0)\n"
+            << "  --fault-drop P         probability of dropping a received list (default 0)\n"
+            << "  --fault-corrupt P      probability of corrupting a reversed list (default 0)\n"
+            << "  --fault-stall-prob P   probability per list of starting a stall episode (default 0)\n"
+            << "  --fault-stall-ms MS    length of a stall episode (default 0)\n"
+            << "  --fault-seed N         seed of the injected faults (default 1)\n";
+}
+
+} // namespace
+
+int
+main(int argc, char** argv)
+{
+  Options opts;
+  for (int idx = 1; idx < argc; ++idx) {
+    std::string arg = argv[idx];
+    if (arg == "-h" || arg == "--help") {
+      usage(argv[0]);
+      return 0;
+    }
+    if (idx + 1 >= argc) {
+      usage(argv[0]);
+      return 1;
+    }
+    std::string value = argv[++idx];
+    if (arg == "--rate") {
+      opts.rate_hz = std::stod(value);
+    } else if (arg == "--min-size") {
+      opts.min_list_size = std::stoi(value);
+    } else if (arg == "--max-size") {
+      opts.max_list_size = std::stoi(value);
+    } else if (arg == "--generators") {
+      opts.generators = std::stoul(value);
+    } else if (arg == "--reversers") {
+      opts.reversers = std::stoul(value);
+    } else if (arg == "--duration") {
+      opts.duration_s = std::stod(value);
+    } else if (arg == "--max-outstanding") {
+      opts.max_outstanding = std::stoul(value);
+    } else if (arg == "--timeout-ms") {
+      opts.timeout = std::chrono::milliseconds(std::stoul(value));
+    } else if (arg == "--transforms") {
+      std::vector<std::string> names;
+      std::istringstream in(value);
+      for (std::string name; std::getline(in, name, ',');) {
+        names.push_back(name);
+      }
+      try {
+        opts.transforms = TransformChain::from_names(names);
+      } catch (const ListTransformError& excpt) {
+        std::cerr << excpt.message() << std::endl;
+        return 1;
+      }
+    } else if (arg == "--fault-delay-us") {
+      opts.faults.delay = std::chrono::microseconds(std::stoul(value));
+    } else if (arg == "--fault-jitter-us") {
+      opts.faults.random_delay = std::chrono::microseconds(std::stoul(value));
+    } else if (arg == "--fault-drop") {
+      opts.faults.drop_probability = std::stod(value);
+    } else if (arg == "--fault-corrupt") {
+      opts.faults.corrupt_probability = std::stod(value);
+    } else if (arg == "--fault-stall-prob") {
+      opts.faults.stall_probability = std::stod(value);
+    } else if (arg == "--fault-stall-ms") {
+      opts.faults.stall = std::chrono::milliseconds(std::stoul(value));
+    } else if (arg == "--fault-seed") {
+      opts.faults.seed = std::stoul(value);
+    } else {
+      usage(argv[0]);
+      return 1;
+    }
+  }
+  if (opts.generators == 0 || opts.reversers == 0 || opts.max_outstanding == 0) {
+    std::cerr << "At least one generator, one reverser and one outstanding request are needed" << std::endl;
+    return 1;
+  }
+
+  std::vector<std::unique_ptr<Generator>> generators;
+  std::vector<std::unique_ptr<Reverser>> reversers;
+  std::vector<Generator*> generator_ptrs;
+  std::vector<Reverser*> reverser_ptrs;
+  std::vector<RequestQueue*> generator_queues;
+  std::vector<IntListQueue*> reverser_queues;
+  for (size_t idx = 0; idx < opts.generators; ++idx) {
+    generators.emplace_back(new Generator(idx, opts));
+    generator_ptrs.push_back(generators.back().get());
+    generator_queues.push_back(&generators.back()->requests());
+  }
+  for (size_t idx = 0; idx < opts.reversers; ++idx) {
+    try {
+      reversers.emplace_back(new Reverser(idx, opts));
+    } catch (const FaultInjectionError& excpt) {
+      std::cerr << excpt.message() << std::endl;
+      return 1;
+    }
+    reverser_ptrs.push_back(reversers.back().get());
+    reverser_queues.push_back(&reversers.back()->lists());
+  }
+  Validator validator(opts);
+
+  std::cout << "Running " << opts.generators << " generators and " << opts.reversers << " reversers for "
+            << opts.duration_s << " s, lists of " << opts.min_list_size << "-" << opts.max_list_size << " elements, "
+            << "rate ";
+  if (opts.rate_hz > 0) {
+    std::cout << opts.rate_hz << " Hz";
+  } else {
+    std::cout << "unlimited";
+  }
+  std::cout << ", " << opts.max_outstanding << " outstanding requests";
+  if (!opts.transforms.empty()) {
+    std::cout << ", kernels " << opts.transforms.describe();
+  }
+  if (reversers.front()->faults_active()) {
+    std::cout << ", faults: " << reversers.front()->describe_faults();
+  }
+  std::cout << std::endl;
+
+  validator.start();
+  for (auto& rev : reversers) {
+    rev->start(generator_queues, &validator.lists());
+  }
+  for (auto& gen : generators) {
+    gen->start(reverser_queues);
+  }
+
+  auto elapsed = validator.run(generator_ptrs, reverser_ptrs);
+
+  g_running = false;
+  for (auto& gen : generators) {
+    gen->join();
+  }
+  for (auto& rev : reversers) {
+    rev->join();
+  }
+  validator.join();
+
+  validator.report(elapsed);
+  size_t missing = 0;
+  for (auto& gen : generators) {
+    missing += gen->missing();
+  }
+  size_t late = 0;
+  for (auto& rev : reversers) {
+    late += rev->late();
+  }
+  std::cout << "Generators:  " << missing << " requests for lists never created; reversers: " << late
+            << " lists without a pending request" << std::endl;
+  if (reversers.front()->faults_active()) {
+    dunedaq::listrev::opmon::FaultInjectionInfo total;
+    for (auto& rev : reversers) {
+      auto info = rev->faults();
+      total.set_messages(total.messages() + info.total_messages());
+      total.set_delay_us(total.delay_us() + info.total_delay_us());
+      total.set_stalls(total.stalls() + info.total_stalls());
+      total.set_stall_us(total.stall_us() + info.total_stall_us());
+      total.set_dropped_messages(total.dropped_messages() + info.total_dropped_messages());
+      total.set_corrupted_messages(total.corrupted_messages() + info.total_corrupted_messages());
+    }
+    std::cout << "Faults:      " << total.messages() << " lists, " << total.delay_us() / 1000 << " ms delay, "
+              << total.stalls() << " stalls for " << total.stall_us() / 1000 << " ms, "
+              << total.dropped_messages() << " dropped, " << total.corrupted_messages() << " corrupted" << std::endl;
+  }
+  return 0;
+}
@@ -3,6 +3,7 @@ import os
 import re
 import urllib.request
 import copy
+import json
 
 import integrationtest.log_file_checks as log_file_checks
 import integrationtest.data_classes as data_classes
@@ -52,6 +53,10 @@ separate_conf.config_db = (
 )
 multigen_conf = copy.deepcopy(common_config_obj)
 multigen_conf.config_db = os.path.dirname(__file__) + "/../config/lrSession.data.xml"
+broadcast_conf = copy.deepcopy(common_config_obj)
+broadcast_conf.config_db = os.path.dirname(__file__) + "/../config/lrSession-broadcast.data.xml"
+transform_conf = copy.deepcopy(common_config_obj)
+transform_conf.config_db = os.path.dirname(__file__) + "/../config/lrSession-transform.data.xml"
 
 confgen_arguments = {
     "Single App": single_app_conf,
@@ -60,7 +65,23 @@ confgen_arguments = {
     "Separate Reverser": r_conf,
     "Independent Apps": separate_conf,
     "Multiple Generators": multigen_conf,
+    "Broadcast Requests": broadcast_conf,
+    "Transform Stages": transform_conf,
 }
+# Performance thresholds checked against the run reports that the modules publish at stop. The validators of
+# these sessions request list sets at 1 Hz; the rate is averaged over the whole run, including the drain.
+default_performance_thresholds = {
+    "min_list_sets_per_s": 0.8,
+    "max_p99_latency_ms": 500,
+    "max_timeouts": 0,
+    "max_dropped_list_sets": 0,
+}
+performance_thresholds = {
+    "Single App": dict(default_performance_thresholds, max_p99_latency_ms=50),
+    "Independent Apps": dict(default_performance_thresholds, max_p99_latency_ms=200),
+    "Multiple Generators": dict(default_performance_thresholds, max_p99_latency_ms=200),
+}
+
 # The commands to run in nanorc, as a list
 nanorc_command_list = (
     "boot wait 5 conf start wait 1 enable-triggers wait ".split()
@@ -163,3 +184,62 @@ def test_log_files(run_nanorc):
     print(f"Checking number of validator errors is 0: {validator_errors}")
     assert validator_errors == 0
     print()
+
+
+def read_run_reports(log_files):
+    """Return the JSON run reports found in the log files, as a list of dicts"""
+    reports = []
+    decoder = json.JSONDecoder()
+    for log_file in log_files:
+        for line in open(log_file, errors='ignore').readlines():
+            idx = line.find("Run report: {")
+            if idx < 0:
+                continue
+            report, _ = decoder.raw_decode(line, idx + len("Run report: "))
+            reports.append(report)
+    return reports
+
+
+def test_run_reports(run_nanorc):
+    current_test = os.environ.get("PYTEST_CURRENT_TEST")
+    match_obj = re.search(r".*\[(.+)\].*", current_test)
+    config_name = ""
+    if match_obj:
+        current_test = match_obj.group(1)
+        config_name = current_test
+    current_test += ": Run Report Check (performance)"
+    banner_line = re.sub(".", "=", current_test)
+    print()
+    print(banner_line)
+    print(current_test)
+    print(banner_line)
+
+    thresholds = performance_thresholds.get(config_name, default_performance_thresholds)
+    reports = read_run_reports(run_nanorc.log_files)
+    validators = [r for r in reports if r["class"] == "ReversedListValidator"]
+    reversers = [r for r in reports if r["class"] == "ListReverser"]
+    generators = [r for r in reports if r["class"] == "RandomDataListGenerator"]
+
+    print()
+    print(f"Checking that every module published a run report: {len(validators)} validators, {len(reversers)} reversers, {len(generators)} generators")
+    assert len(validators) > 0 and len(reversers) > 0 and len(generators) > 0
+    for report in validators:
+        name = report["module"]
+        p99_ms = report["latency"]["p99_us"] / 1000
+        print(f"Checking list set rate of {name}: {report['list_sets_per_s']} >= {thresholds['min_list_sets_per_s']} per s")
+        assert report["list_sets_per_s"] >= thresholds["min_list_sets_per_s"]
+        print(f"Checking p99 latency of {name}: {p99_ms} <= {thresholds['max_p99_latency_ms']} ms")
+        assert p99_ms <= thresholds["max_p99_latency_ms"]
+        print(f"Checking timeouts of {name}: {report['timeouts']} <= {thresholds['max_timeouts']}")
+        assert report["timeouts"] <= thresholds["max_timeouts"]
+        print(f"Checking mismatches of {name} are 0: {report['mismatches']}")
+        assert report["mismatches"] == 0
+    for report in reversers:
+        name = report["module"]
+        print(f"Checking dropped list sets of {name}: {report['dropped_list_sets']} <= {thresholds['max_dropped_list_sets']}")
+        assert report["dropped_list_sets"] <= thresholds["max_dropped_list_sets"]
+    for report in generators:
+        name = report["module"]
+        print(f"Checking that {name} sent lists: {report['lists_sent']}, {report['elements_per_s']} elements/s, {report['bytes_per_s']} bytes/s")
+        assert report["lists_sent"] > 0
+    print()
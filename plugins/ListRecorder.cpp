@@ -0,0 +1,197 @@
+/**
+ * @file ListRecorder.cpp ListRecorder class
+ * implementation
+ *
+ * This is part of the DUNE DAQ Software Suite, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#include "listrev/dal/ListRecorder.hpp"
+
+#include "listrev/opmon/list_rev_info.pb.h"
+
+#include "CommonIssues.hpp"
+#include "ListEncoding.hpp"
+#include "ListRecorder.hpp"
+
+#include "appfwk/ModuleConfiguration.hpp"
+#include "confmodel/Connection.hpp"
+
+#include "iomanager/IOManager.hpp"
+#include "logging/Logging.hpp"
+
+#include <string>
+#include <vector>
+
+/**
+ * @brief Name used by TRACE TLOG calls from this source file
+ */
+#define TRACE_NAME "ListRecorder" // NOLINT
+#define TLVL_ENTER_EXIT_METHODS 10
+#define TLVL_RECORDING 15
+
+namespace dunedaq {
+namespace listrev {
+
+ListRecorder::ListRecorder(const std::string& name)
+  : DAQModule(name)
+{
+  register_command("start", &ListRecorder::do_start);
+  register_command("stop", &ListRecorder::do_stop);
+}
+
+void
+ListRecorder::init(std::shared_ptr<appfwk::ModuleConfiguration> mcfg)
+{
+  TLOG_DEBUG(TLVL_ENTER_EXIT_METHODS) << get_name() << ": Entering init() method";
+  auto mdal = mcfg->module<dal::ListRecorder>(get_name());
+  if (mdal == nullptr) {
+    throw appfwk::CommandFailed(ERS_HERE, get_name(), "init", "Unable to load module configuration");
+  }
+
+  for (auto con : mdal->get_inputs()) {
+    if (con->get_data_type() == datatype_to_string<IntList>()) {
+      m_int_list_connections.push_back(con->UID());
+    } else if (con->get_data_type() == datatype_to_string<ReversedList>()) {
+      m_reversed_list_connections.push_back(con->UID());
+    }
+  }
+
+  try {
+    for (auto& conn : m_int_list_connections) {
+      get_iom_receiver<IntList>(conn);
+    }
+    for (auto& conn : m_reversed_list_connections) {
+      get_iom_receiver<ReversedList>(conn);
+    }
+  } catch (const ers::Issue& excpt) {
+    throw InvalidQueueFatalError(ERS_HERE, get_name(), "input", excpt);
+  }
+
+  m_output_path = mdal->get_output_path();
+  m_chunk_size = static_cast<size_t>(mdal->get_file_chunk_mb()) * 1024 * 1024;
+
+  TLOG_DEBUG(TLVL_ENTER_EXIT_METHODS) << get_name() << ": Exiting init() method";
+}
+
+void
+ListRecorder::generate_opmon_data()
+{
+  opmon::ListRecorderInfo info;
+
+  auto records = m_records.snapshot();
+  auto bytes = m_bytes.snapshot();
+  info.set_records_written(records.total);
+  info.set_new_records_written(records.delta);
+  info.set_bytes_written(bytes.total);
+  info.set_new_bytes_written(bytes.delta);
+
+  publish(std::move(info));
+}
+
+void
+ListRecorder::do_start(const nlohmann::json& startobj)
+{
+  TLOG_DEBUG(TLVL_ENTER_EXIT_METHODS) << get_name() << ": Entering do_start() method";
+
+  std::ostringstream oss_file;
+  oss_file << m_output_path << "/" << get_name() << "_run" << startobj.value<uint64_t>("run", 0) // NOLINT
+           << ".lrec";
+  try {
+    m_writer.reset(new ListFileWriter(oss_file.str(), m_chunk_size));
+  } catch (const ListFileError& excpt) {
+    throw appfwk::CommandFailed(ERS_HERE, get_name(), "start", "cannot create the recording file", excpt);
+  }
+
+  auto iom = iomanager::IOManager::get();
+  for (auto& conn : m_int_list_connections) {
+    iom->add_callback<IntList>(conn, std::bind(&ListRecorder::record_int_list, this, std::placeholders::_1));
+  }
+  for (auto& conn : m_reversed_list_connections) {
+    iom->add_callback<ReversedList>(conn,
+                                    std::bind(&ListRecorder::record_reversed_list, this, std::placeholders::_1));
+  }
+
+  TLOG() << get_name() << " successfully started, recording to " << oss_file.str();
+  TLOG_DEBUG(TLVL_ENTER_EXIT_METHODS) << get_name() << ": Exiting do_start() method";
+}
+
+void
+ListRecorder::do_stop(const nlohmann::json& /*stopobj*/)
+{
+  TLOG_DEBUG(TLVL_ENTER_EXIT_METHODS) << get_name() << ": Entering do_stop() method";
+
+  auto iom = iomanager::IOManager::get();
+  for (auto& conn : m_int_list_connections) {
+    iom->remove_callback<IntList>(conn);
+  }
+  for (auto& conn : m_reversed_list_connections) {
+    iom->remove_callback<ReversedList>(conn);
+  }
+
+  std::string path;
+  if (m_writer != nullptr) {
+    path = m_writer->path();
+    m_writer->close();
+    m_writer.reset();
+  }
+  TLOG() << get_name() << " successfully stopped";
+
+  std::ostringstream oss_summ;
+  oss_summ << ": Exiting do_stop() method, recorded " << m_records.total() << " records (" << m_bytes.total()
+           << " bytes) to " << path;
+  ers::info(ProgressUpdate(ERS_HERE, get_name(), oss_summ.str()));
+
+  TLOG_DEBUG(TLVL_ENTER_EXIT_METHODS) << get_name() << ": Exiting do_stop() method";
+}
+
+void
+ListRecorder::record_int_list(const IntList& list)
+{
+  TLOG_DEBUG(TLVL_RECORDING) << get_name() << ": Recording list #" << list.list_id << " from generator "
+                             << list.generator_id;
+  if (!list.shm_ring.empty()) {
+    // Only the descriptor was sent; reading the payload would take it away from the reverser
+    TLOG_DEBUG(TLVL_RECORDING) << get_name() << ": Not recording list #" << list.list_id
+                               << ", its payload is in shared-memory ring " << list.shm_ring;
+    return;
+  }
+  try {
+    IntList scratch;
+    m_bytes += m_writer->append(decoded(list, scratch));
+    ++m_records;
+  } catch (const ListFileError& excpt) {
+    ers::error(excpt);
+  } catch (const ListEncodingError& excpt) {
+    ers::error(excpt);
+  }
+}
+
+void
+ListRecorder::record_reversed_list(const ReversedList& list)
+{
+  if (list.drain_ack) {
+    return;
+  }
+  TLOG_DEBUG(TLVL_RECORDING) << get_name() << ": Recording reversed lists #" << list.list_id << " from reverser "
+                             << list.reverser_id;
+  try {
+    ReversedList scratch;
+    m_bytes += m_writer->append(decoded(list, scratch));
+    ++m_records;
+  } catch (const ListFileError& excpt) {
+    ers::error(excpt);
+  } catch (const ListEncodingError& excpt) {
+    ers::error(excpt);
+  }
+}
+
+} // namespace listrev
+} // namespace dunedaq
+
+DEFINE_DUNE_DAQ_MODULE(dunedaq::listrev::ListRecorder)
+
+// Local Variables:
+// c-basic-offset: 2
+// End:
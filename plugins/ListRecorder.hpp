@@ -0,0 +1,85 @@
+/**
+ * @file ListRecorder.hpp
+ *
+ * ListRecorder is a DAQModule that subscribes to IntList and ReversedList
+ * connections and appends every message it receives to a list file, which
+ * RandomDataListGenerator can replay.
+ *
+ * This is part of the DUNE DAQ Software Suite, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#ifndef LISTREV_PLUGINS_LISTRECORDER_HPP_
+#define LISTREV_PLUGINS_LISTRECORDER_HPP_
+
+#include "ListFile.hpp"
+#include "ListWrapper.hpp"
+#include "ShardedCounter.hpp"
+
+#include "appfwk/DAQModule.hpp"
+
+#include <ers/Issue.hpp>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace dunedaq {
+namespace listrev {
+
+/**
+ * @brief ListRecorder writes the lists seen on its input connections to a
+ * memory-mapped file, one file per run.
+ */
+class ListRecorder : public dunedaq::appfwk::DAQModule
+{
+public:
+  /**
+   * @brief ListRecorder Constructor
+   * @param name Instance name for this ListRecorder instance
+   */
+  explicit ListRecorder(const std::string& name);
+
+  ListRecorder(const ListRecorder&) = delete;            ///< ListRecorder is not copy-constructible
+  ListRecorder& operator=(const ListRecorder&) = delete; ///< ListRecorder is not copy-assignable
+  ListRecorder(ListRecorder&&) = delete;                 ///< ListRecorder is not move-constructible
+  ListRecorder& operator=(ListRecorder&&) = delete;      ///< ListRecorder is not move-assignable
+
+  void init(std::shared_ptr<appfwk::ModuleConfiguration> mcfg) override;
+
+protected:
+  void generate_opmon_data() override;
+
+private:
+  // Commands
+  void do_start(const nlohmann::json& obj);
+  void do_stop(const nlohmann::json& obj);
+
+  // Callbacks
+  void record_int_list(const IntList& list);
+  void record_reversed_list(const ReversedList& list);
+
+  // Init
+  std::vector<std::string> m_int_list_connections;
+  std::vector<std::string> m_reversed_list_connections;
+
+  // Configuration
+  std::string m_output_path{ "." };
+  size_t m_chunk_size{ 64 * 1024 * 1024 };
+
+  // Data
+  std::unique_ptr<ListFileWriter> m_writer;
+
+  // Monitoring
+  ShardedCounter m_records;
+  ShardedCounter m_bytes;
+};
+} // namespace listrev
+} // namespace dunedaq
+
+#endif // LISTREV_PLUGINS_LISTRECORDER_HPP_
+
+// Local Variables:
+// c-basic-offset: 2
+// End:
@@ -0,0 +1,63 @@
+/**
+ * @file ListTransformer.cpp ListTransformer class
+ * implementation
+ *
+ * This is part of the DUNE DAQ Software Suite, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#include "listrev/dal/ListTransformer.hpp"
+
+#include "CommonIssues.hpp"
+#include "ListTransformer.hpp"
+
+#include "appfwk/ModuleConfiguration.hpp"
+
+#include "logging/Logging.hpp"
+
+#include <string>
+
+/**
+ * @brief Name used by TRACE TLOG calls from this source file
+ */
+#define TRACE_NAME "ListTransformer" // NOLINT
+#define TLVL_ENTER_EXIT_METHODS 10
+#define TLVL_CONFIGURE 17
+
+namespace dunedaq {
+namespace listrev {
+
+ListTransformer::ListTransformer(const std::string& name)
+  : ListReverser(name)
+{
+}
+
+void
+ListTransformer::init(std::shared_ptr<appfwk::ModuleConfiguration> mcfg)
+{
+  TLOG_DEBUG(TLVL_ENTER_EXIT_METHODS) << get_name() << ": Entering init() method";
+  ListReverser::init(mcfg);
+
+  auto mdal = mcfg->module<dal::ListTransformer>(get_name());
+  if (mdal->get_kernels().empty()) {
+    throw appfwk::CommandFailed(ERS_HERE, get_name(), "init", "At least one kernel is needed");
+  }
+  try {
+    m_transforms = TransformChain::from_names(mdal->get_kernels());
+  } catch (const ListTransformError& excpt) {
+    throw appfwk::CommandFailed(ERS_HERE, get_name(), "init", "Invalid kernels", excpt);
+  }
+
+  TLOG_DEBUG(TLVL_CONFIGURE) << "ListTransformer " << get_name() << " applies " << m_transforms.describe();
+  TLOG_DEBUG(TLVL_ENTER_EXIT_METHODS) << get_name() << ": Exiting init() method";
+}
+
+} // namespace listrev
+} // namespace dunedaq
+
+DEFINE_DUNE_DAQ_MODULE(dunedaq::listrev::ListTransformer)
+
+// Local Variables:
+// c-basic-offset: 2
+// End:
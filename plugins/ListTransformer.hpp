@@ -0,0 +1,45 @@
+/**
+ * @file ListTransformer.hpp
+ *
+ * ListTransformer is a ListReverser that applies a configured chain of
+ * kernels (see ListTransforms.hpp) to each list instead of reversing it.
+ * Requests, list-set assembly, deadlines, flow control and draining are
+ * those of ListReverser, so a transformer can stand in for a reverser, and
+ * several transformers with different kernels can serve one validator.
+ *
+ * This is part of the DUNE DAQ Software Suite, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#ifndef LISTREV_PLUGINS_LISTTRANSFORMER_HPP_
+#define LISTREV_PLUGINS_LISTTRANSFORMER_HPP_
+
+#include "ListReverser.hpp"
+
+#include <memory>
+#include <string>
+
+namespace dunedaq {
+namespace listrev {
+
+class ListTransformer : public ListReverser
+{
+public:
+  /**
+   * @brief ListTransformer Constructor
+   * @param name Instance name for this ListTransformer instance
+   */
+  explicit ListTransformer(const std::string& name);
+
+  void init(std::shared_ptr<appfwk::ModuleConfiguration> mcfg) override;
+};
+
+} // namespace listrev
+} // namespace dunedaq
+
+#endif // LISTREV_PLUGINS_LISTTRANSFORMER_HPP_
+
+// Local Variables:
+// c-basic-offset: 2
+// End:
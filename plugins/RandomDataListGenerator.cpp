@@ -11,6 +11,9 @@
 #include "listrev/opmon/list_rev_info.pb.h"
 
 #include "CommonIssues.hpp"
+#include "ListEncoding.hpp"
+#include "ListTrace.hpp"
+#include "ThreadPlacement.hpp"
 #include "RandomDataListGenerator.hpp"
 
 #include "appfwk/ModuleConfiguration.hpp"
@@ -20,6 +23,7 @@
 #include "iomanager/IOManager.hpp"
 #include "logging/Logging.hpp"
 
+#include <algorithm>
 #include <chrono>
 #include <cstdlib>
 #include <set>
@@ -39,6 +43,7 @@ namespace listrev {
 
 RandomDataListGenerator::RandomDataListGenerator(const std::string& name)
   : dunedaq::appfwk::DAQModule(name)
+  , m_heartbeat_thread(std::bind(&RandomDataListGenerator::send_heartbeats, this, std::placeholders::_1))
 {
   register_command("conf", &RandomDataListGenerator::do_conf);
   register_command("start", &RandomDataListGenerator::do_start);
@@ -63,19 +68,105 @@ RandomDataListGenerator::init(std::shared_ptr<appfwk::ModuleConfiguration> mcfg)
       m_create_connection = con->UID();
     }
     if (con->get_data_type() == datatype_to_string<RequestList>()) {
-      m_request_connection = con->UID();
+      // A generator may be served by several reversers, either directly or through their broadcast request topics
+      m_request_connections.push_back(con->UID());
+    }
+  }
+  for (auto con : mdal->get_outputs()) {
+    if (con->get_data_type() == datatype_to_string<IntList>()) {
+      m_list_connections.insert(con->UID());
+    }
+    if (con->get_data_type() == datatype_to_string<GeneratorHeartbeat>()) {
+      m_heartbeat_connection = con->UID();
     }
   }
 
   // these are just tests to check if the connections are ok
   auto iom = iomanager::IOManager::get();
-  iom->get_receiver<RequestList>(m_request_connection);
+  for (auto& conn : m_request_connections) {
+    iom->get_receiver<RequestList>(conn);
+  }
   iom->get_receiver<CreateList>(m_create_connection);
+  if (!m_heartbeat_connection.empty()) {
+    iom->get_sender<GeneratorHeartbeat>(m_heartbeat_connection);
+  }
 
   m_send_timeout = std::chrono::milliseconds(mdal->get_send_timeout_ms());
   m_request_timeout = std::chrono::milliseconds(mdal->get_request_timeout_ms());
   m_generator_id = mdal->get_generator_id();
-  m_list_mode = static_cast<ListMode>(m_generator_id % (static_cast<uint16_t>(ListMode::MAX) + 1));
+  m_heartbeat_interval = std::chrono::milliseconds(std::max(mdal->get_heartbeat_interval_ms(), 1u));
+  m_list_mode = list_mode_for_generator(m_generator_id);
+  m_warmup_lists = mdal->get_warmup_lists();
+  m_warmup_min_list_size = mdal->get_warmup_min_list_size();
+  m_warmup_max_list_size = mdal->get_warmup_max_list_size();
+  m_list_size_seed = mdal->get_list_size_seed();
+  m_shm_ring_size = size_t(mdal->get_shm_ring_mb()) << 20;
+  m_shm_lease = std::chrono::milliseconds(mdal->get_shm_lease_ms());
+  m_host = ShmListRing::local_host();
+  // Keep room for the lists created during the run, so that warm lists are not evicted before they are requested
+  m_storage.set_capacity(ListStorage::s_default_capacity + m_warmup_lists);
+
+  try {
+    m_list_encoding = parse_list_encoding(mdal->get_list_encoding());
+  } catch (const ListEncodingError& excpt) {
+    throw appfwk::CommandFailed(ERS_HERE, get_name(), "init", "Invalid list_encoding", excpt);
+  }
+
+  try {
+    m_callback_placement.configure(mdal->get_callback_cpus(), mdal->get_local_memory());
+  } catch (const ThreadPlacementError& excpt) {
+    throw appfwk::CommandFailed(ERS_HERE, get_name(), "init", "Invalid thread placement", excpt);
+  }
+  m_parallel = shared_pool_policy(mdal->get_parallel_threads(), mdal->get_parallel_threshold());
+  try {
+    m_faults.configure(mdal->get_fault_injection(), get_name());
+  } catch (const FaultInjectionError& excpt) {
+    throw appfwk::CommandFailed(ERS_HERE, get_name(), "init", "Invalid fault injection", excpt);
+  }
+  // The reverser returns the list it received as the original, so a list corrupted here would still validate
+  if (m_faults.disable_corruption()) {
+    ers::warning(FaultInjectionError(
+      ERS_HERE, "corrupt_probability is ignored by " + get_name() + ", it would not be detected downstream"));
+  }
+  if (m_faults.active()) {
+    ers::info(ProgressUpdate(ERS_HERE, get_name(), "injecting faults: " + m_faults.describe()));
+  }
+
+  if (!mdal->get_trace_path().empty()) {
+    try {
+      ListTracer::get().enable(mdal->get_trace_path());
+    } catch (const TraceFileError& excpt) {
+      throw appfwk::CommandFailed(ERS_HERE, get_name(), "init", "Unable to create the trace file", excpt);
+    }
+  }
+  m_trace_track = ListTracer::get().track(get_name());
+
+  if (!mdal->get_replay_file().empty()) {
+    try {
+      m_replay.reset(new ListFileReader(mdal->get_replay_file()));
+    } catch (const ListFileError& excpt) {
+      throw appfwk::CommandFailed(ERS_HERE, get_name(), "init", "Unable to open the replay file", excpt);
+    }
+
+    // Prefer the lists recorded from this generator; a file recorded with other generator ids is served as a whole
+    for (bool any_generator : { false, true }) {
+      for (size_t idx = 0; idx < m_replay->size(); ++idx) {
+        auto& rec = m_replay->record(idx);
+        if (rec.type == ListRecordType::IntList &&
+            (any_generator || rec.source_id == static_cast<int>(m_generator_id))) {
+          m_replay_index.emplace(rec.list_id, idx);
+          m_replay_order.push_back(idx);
+        }
+      }
+      if (!m_replay_order.empty()) {
+        break;
+      }
+    }
+    if (m_replay_order.empty()) {
+      throw appfwk::CommandFailed(ERS_HERE, get_name(), "init", "The replay file contains no IntList records");
+    }
+    TLOG() << get_name() << ": replaying " << m_replay_order.size() << " lists from " << m_replay->path();
+  }
 
   TLOG_DEBUG(TLVL_ENTER_EXIT_METHODS) << get_name() << ": Exiting init() method";
 }
@@ -85,12 +176,58 @@ RandomDataListGenerator::generate_opmon_data()
 {
   opmon::RandomListGeneratorInfo fcr;
 
-  fcr.set_generated_numbers(m_generated_tot.load());
-  fcr.set_new_generated_numbers(m_generated.exchange(0));
-  fcr.set_lists_sent(m_sent_tot.load());
-  fcr.set_new_lists_sent(m_sent.exchange(0));
+  auto now = std::chrono::steady_clock::now();
+  double interval_s = std::chrono::duration<double>(now - m_last_opmon_time).count();
+  m_last_opmon_time = now;
+
+  auto generated = m_generated.snapshot();
+  auto generated_elements = m_generated_elements.snapshot();
+  auto sent = m_sent.snapshot();
+  auto elements_sent = m_elements_sent.snapshot();
+  auto bytes_sent = m_bytes_sent.snapshot();
+  auto filtered = m_filtered.snapshot();
+  auto expired_requests = m_expired_requests.snapshot();
+  auto expired_creates = m_expired_creates.snapshot();
+  auto heartbeats_sent = m_heartbeats_sent.snapshot();
+  auto shm_lists = m_shm_lists.snapshot();
+  auto shm_fallbacks = m_shm_fallbacks.snapshot();
+
+  fcr.set_generated_lists(generated.total);
+  fcr.set_new_generated_lists(generated.delta);
+  fcr.set_generated_elements(generated_elements.total);
+  fcr.set_new_generated_elements(generated_elements.delta);
+  fcr.set_lists_sent(sent.total);
+  fcr.set_new_lists_sent(sent.delta);
+
+  fcr.set_elements_sent(elements_sent.total);
+  fcr.set_new_elements_sent(elements_sent.delta);
+  fcr.set_bytes_sent(bytes_sent.total);
+  fcr.set_new_bytes_sent(bytes_sent.delta);
+  if (interval_s > 0) {
+    fcr.set_elements_per_second(elements_sent.delta / interval_s);
+    fcr.set_bytes_per_second(bytes_sent.delta / interval_s);
+  }
+  fcr.set_requests_filtered(filtered.total);
+  fcr.set_new_requests_filtered(filtered.delta);
+  fcr.set_expired_requests(expired_requests.total);
+  fcr.set_new_expired_requests(expired_requests.delta);
+  fcr.set_expired_creates(expired_creates.total);
+  fcr.set_new_expired_creates(expired_creates.delta);
+  fcr.set_heartbeats_sent(heartbeats_sent.total);
+  fcr.set_new_heartbeats_sent(heartbeats_sent.delta);
+  fcr.set_shm_lists(shm_lists.total);
+  fcr.set_new_shm_lists(shm_lists.delta);
+  fcr.set_shm_fallbacks(shm_fallbacks.total);
+  fcr.set_new_shm_fallbacks(shm_fallbacks.delta);
 
   publish( std::move(fcr) );
+  if (m_faults.active()) {
+    publish(m_faults.generate_opmon_data());
+  }
+
+  m_list_senders.for_each([&](const std::string& conn, SendStatistics& stats) {
+    publish(stats.generate_opmon_data(), { { "connection", conn } });
+  });
 }
 
 void
@@ -102,6 +239,7 @@ RandomDataListGenerator::do_conf(const nlohmann::json& /*args*/)
   // Add this callback early as this is a pub/sub connection
   iom->add_callback<CreateList>(m_create_connection,
                                 std::bind(&RandomDataListGenerator::process_create_list, this, std::placeholders::_1));
+  warm_up();
 
   TLOG() << get_name() << " successfully configured";
   TLOG_DEBUG(TLVL_ENTER_EXIT_METHODS) << get_name() << ": Exiting do_conf() method";
@@ -113,9 +251,40 @@ RandomDataListGenerator::do_start(const nlohmann::json& /*args*/)
 {
   TLOG_DEBUG(TLVL_ENTER_EXIT_METHODS) << get_name() << ": Entering do_start() method";
 
+  // Resolve the known destinations up front; any other request destination is resolved on first use
+  for (auto& conn : m_list_connections) {
+    m_list_senders.resolve(conn);
+  }
+
+  if (m_callback_placement.active()) {
+    ers::info(ProgressUpdate(ERS_HERE, get_name(), "callback threads to be placed on " + m_callback_placement.describe()));
+  }
+  m_response_latency.reset();
+  // Storage is flushed at stop; warming again here keeps the stop transition short
+  if (!m_storage_warm) {
+    warm_up();
+  }
+  {
+    // No reverser is reading while stopped, so blocks left over from the last run can go
+    std::lock_guard<std::mutex> lk(m_shm_mutex);
+    for (auto& [destination, ring] : m_shm_rings) {
+      if (ring != nullptr) {
+        ring->reset();
+      }
+    }
+  }
+  m_run_report.start({ &m_generated, &m_generated_elements, &m_sent, &m_elements_sent, &m_bytes_sent, &m_filtered,
+                       &m_expired_requests, &m_expired_creates, &m_shm_lists, &m_shm_fallbacks });
+  m_running = true;
   auto iom = iomanager::IOManager::get();
-  iom->add_callback<RequestList>(
-    m_request_connection, std::bind(&RandomDataListGenerator::process_request_list, this, std::placeholders::_1));
+  for (auto& conn : m_request_connections) {
+    iom->add_callback<RequestList>(
+      conn, std::bind(&RandomDataListGenerator::process_request_list, this, std::placeholders::_1));
+  }
+  // Announce only once requests can be served
+  if (!m_heartbeat_connection.empty()) {
+    m_heartbeat_thread.start_working_thread("heartbeat");
+  }
 
   TLOG() << get_name() << " successfully started";
   TLOG_DEBUG(TLVL_ENTER_EXIT_METHODS) << get_name() << ": Exiting do_start() method";
@@ -126,19 +295,51 @@ RandomDataListGenerator::do_stop(const nlohmann::json& /*args*/)
 {
   TLOG_DEBUG(TLVL_ENTER_EXIT_METHODS) << get_name() << ": Entering do_stop() method";
 
+  // Interrupt any request still waiting for its list, so that removing the callbacks does not wait for it
+  m_running = false;
+  if (m_heartbeat_thread.thread_running()) {
+    m_heartbeat_thread.stop_working_thread();
+    send_heartbeat(true);
+  }
   auto iom = iomanager::IOManager::get();
-  iom->remove_callback<RequestList>(m_request_connection);
+  for (auto& conn : m_request_connections) {
+    iom->remove_callback<RequestList>(conn);
+  }
   iom->remove_callback<CreateList>(m_create_connection);
+  auto discarded = m_storage.size();
+  m_run_report.stop();
   m_storage.flush();
+  m_storage_warm = false;
+  m_list_senders.clear();
+  ListTracer::get().flush();
 
   TLOG() << get_name() << " successfully stopped";
 
   std::ostringstream oss_summ;
   oss_summ << ": Exiting do_stop() method, "
-           << "generated " << m_generated_tot.load() << " lists, "
-           << "and sent " << m_sent_tot.load() << " list messages";
+           << "generated " << m_generated.total() << " lists, "
+           << "and sent " << m_sent.total() << " list messages, "
+           << "ignored " << m_filtered.total() << " requests for other reversers, "
+           << "discarded " << discarded << " stored lists, "
+           << "shed " << m_expired_requests.total() << " expired requests and " << m_expired_creates.total()
+           << " expired creates";
   ers::info(ProgressUpdate(ERS_HERE, get_name(), oss_summ.str()));
 
+  m_run_report.add_count("lists_generated", m_generated);
+  m_run_report.add_rate("generated_elements_per_s", m_generated_elements);
+  m_run_report.add_count("lists_sent", m_sent);
+  m_run_report.add_rate("lists_per_s", m_sent);
+  m_run_report.add_rate("elements_per_s", m_elements_sent);
+  m_run_report.add_rate("bytes_per_s", m_bytes_sent);
+  m_run_report.add_latency("response_latency", m_response_latency);
+  m_run_report.add_count("filtered_requests", m_filtered);
+  m_run_report.add_count("expired_requests", m_expired_requests);
+  m_run_report.add_count("expired_creates", m_expired_creates);
+  m_run_report.add_count("shm_lists", m_shm_lists);
+  m_run_report.add_count("shm_fallbacks", m_shm_fallbacks);
+  m_run_report.add("discarded_lists", discarded);
+  ers::info(EndOfRunReport(ERS_HERE, get_name(), m_run_report.str(get_name())));
+
   TLOG_DEBUG(TLVL_ENTER_EXIT_METHODS) << get_name() << ": Exiting do_stop() method";
 }
 
@@ -146,6 +347,10 @@ void
 RandomDataListGenerator::do_unconfigure(const nlohmann::json& /*args*/)
 {
   TLOG_DEBUG(TLVL_ENTER_EXIT_METHODS) << get_name() << ": Entering do_unconfigure() method";
+  {
+    std::lock_guard<std::mutex> lk(m_shm_mutex);
+    m_shm_rings.clear();
+  }
 
   TLOG_DEBUG(TLVL_ENTER_EXIT_METHODS) << get_name() << ": Exiting do_unconfigure() method";
 }
@@ -158,99 +363,173 @@ RandomDataListGenerator::do_hello(const nlohmann::json& /*args*/)
   TLOG_DEBUG(TLVL_ENTER_EXIT_METHODS) << get_name() << ": Exiting do_hello() method";
 }
 
-/**
- * @brief Format a std::vector<int> to a stream
- * @param t ostream Instance
- * @param ints Vector to format
- * @return ostream Instance
- */
-std::ostream&
-operator<<(std::ostream& t, std::vector<int> ints)
-{
-  t << "{";
-  bool first = true;
-  for (auto& i : ints) {
-    if (!first)
-      t << ", ";
-    first = false;
-    t << i;
-  }
-  return t << "}";
-}
-
 void
 RandomDataListGenerator::process_create_list(const CreateList& create_request)
 {
   TLOG_DEBUG(TLVL_ENTER_EXIT_METHODS) << get_name() << ": Entering process_create_list() method";
+  m_callback_placement.place(get_name(), "create callback");
+  if (m_replay != nullptr) {
+    // The list is taken from the replay file when it is requested
+    TLOG_DEBUG(TLVL_LIST_GENERATION) << get_name() << ": Replaying list #" << create_request.list_id;
+    return;
+  }
+  if (deadline_passed(create_request.deadline_ns)) {
+    // The request for this list has already timed out at the validator, so nobody will ask for it in time
+    TLOG_DEBUG(TLVL_LIST_GENERATION) << get_name() << ": Not generating expired list #" << create_request.list_id;
+    ++m_expired_creates;
+    return;
+  }
+
+  ListTracer::get().hop(m_trace_track, "create transit", create_request);
+  auto trace_start = ListTracer::now_ns();
+
   std::vector<int> theList(create_request.list_size);
 
   TLOG_DEBUG(TLVL_LIST_GENERATION) << get_name() << ": Start of fill loop";
-  for (size_t idx = 0; idx < create_request.list_size; ++idx) {
-    switch (m_list_mode) {
-      case ListMode::Random:
-        theList[idx] = (rand() % 1000) + 1;
-        break;
-      case ListMode::Ascending:
-        theList[idx] = create_request.list_id + idx;
-        break;
-      case ListMode::Evens:
-        theList[idx] = (create_request.list_id % 2 == 0 ? 0 : 1) + create_request.list_id + idx * 2;
-        break;
-      case ListMode::Odds:
-        theList[idx] = (create_request.list_id % 2 == 0 ? 1 : 0) + create_request.list_id + idx * 2;
-        break;
-      case ListMode::Descending:
-        theList[idx] = create_request.list_id - idx;
-        break;
-    }
-  }
-  ++m_generated_tot;
+  fill_list(m_list_mode, create_request.list_id, theList, m_parallel);
   ++m_generated;
+  m_generated_elements += theList.size();
   std::ostringstream oss_prog;
-  oss_prog << "Generated list #" << create_request.list_id << " with contents " << theList << " and size "
-           << theList.size() << ". ";
+  oss_prog << "Generated list #" << create_request.list_id << " with size " << theList.size() << ". ";
   ers::debug(ProgressUpdate(ERS_HERE, get_name(), oss_prog.str()));
 
-  m_storage.add_list(IntList(create_request.list_id, m_generator_id, theList));
+  // With warm-up, a CreateList for a warm id (e.g. from a validator without warm-up) replaces the pre-generated list
+  m_storage.add_list(IntList(create_request.list_id, m_generator_id, theList), m_warmup_lists > 0);
+  if (create_request.trace_id != 0) {
+    ListTracer::get().record(
+      m_trace_track, "generate", create_request.trace_id, create_request.list_id, trace_start, ListTracer::now_ns());
+  }
 
   TLOG_DEBUG(TLVL_ENTER_EXIT_METHODS) << get_name() << ": Exiting process_create_list() method";
 }
 
+void
+RandomDataListGenerator::send_heartbeats(std::atomic<bool>& running_flag)
+{
+  auto next = std::chrono::steady_clock::now();
+  while (running_flag.load()) {
+    auto now = std::chrono::steady_clock::now();
+    if (now >= next) {
+      send_heartbeat(false);
+      next = now + m_heartbeat_interval;
+    }
+    std::this_thread::sleep_for(std::min(m_heartbeat_interval, std::chrono::milliseconds(10)));
+  }
+}
+
+void
+RandomDataListGenerator::send_heartbeat(bool withdraw)
+{
+  GeneratorHeartbeat heartbeat(m_generator_id, m_request_connections);
+  heartbeat.withdraw = withdraw;
+  try {
+    get_iom_sender<GeneratorHeartbeat>(m_heartbeat_connection)->send(std::move(heartbeat), m_send_timeout);
+    ++m_heartbeats_sent;
+  } catch (const dunedaq::iomanager::TimeoutExpired& excpt) {
+    ers::warning(excpt);
+  }
+}
+
 void
 RandomDataListGenerator::process_request_list(const RequestList& request)
 {
   TLOG_DEBUG(TLVL_ENTER_EXIT_METHODS) << get_name() << ": Entering process_request_list() method";
-  auto start = std::chrono::steady_clock::now();
+  m_callback_placement.place(get_name(), "request callback");
+
+  // Requests published on a broadcast topic reach every subscribed generator; only answer reversers we are connected to
+  if (!m_list_connections.empty() && !m_list_connections.count(request.destination)) {
+    TLOG_DEBUG(TLVL_LIST_GENERATION) << get_name() << ": Ignoring request for list " << request.list_id
+                                     << " with destination " << request.destination;
+    ++m_filtered;
+    return;
+  }
+  if (deadline_passed(request.deadline_ns)) {
+    TLOG_DEBUG(TLVL_LIST_GENERATION) << get_name() << ": Dropping expired request for list " << request.list_id;
+    ++m_expired_requests;
+    return;
+  }
+  ListTracer::get().hop(m_trace_track, "request transit", request);
+  auto trace_start = ListTracer::now_ns();
+  auto received = std::chrono::steady_clock::now();
+
   IntList output;
-  bool list_found = false;
-
-  while (std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start) <
-         m_request_timeout) {
-    if (m_storage.has_list(request.list_id)) {
-      output = m_storage.get_list(request.list_id);
-      list_found = true;
-      break;
+  if (m_replay != nullptr) {
+    output = replay_list(request.list_id);
+  } else {
+    auto start = std::chrono::steady_clock::now();
+    bool list_found = false;
+    bool expired = false;
+
+    while (m_running.load() && !(expired = deadline_passed(request.deadline_ns)) &&
+           std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start) <
+             m_request_timeout) {
+      if (m_storage.has_list(request.list_id)) {
+        output = m_storage.get_list(request.list_id);
+        list_found = true;
+        break;
+      }
+      std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+
+    if (!list_found && !m_running.load()) {
+      return;
+    }
+    if (!list_found && expired) {
+      ++m_expired_requests;
+      return;
+    }
+    if (!list_found) {
+      std::ostringstream oss_warn;
+      oss_warn << "wait for list \"" << request.list_id << "\"";
+      ers::warning(dunedaq::iomanager::TimeoutExpired(
+        ERS_HERE,
+        get_name(),
+        oss_warn.str(),
+        std::chrono::duration_cast<std::chrono::milliseconds>(m_request_timeout).count()));
+      return;
     }
-    std::this_thread::sleep_for(std::chrono::microseconds(100));
   }
 
-  if (!list_found) {
-    std::ostringstream oss_warn;
-    oss_warn << "wait for list \"" << request.list_id << "\"";
-    ers::warning(dunedaq::iomanager::TimeoutExpired(
-      ERS_HERE,
-      get_name(),
-      oss_warn.str(),
-      std::chrono::duration_cast<std::chrono::milliseconds>(m_request_timeout).count()));
+  if (request.trace_id != 0) {
+    auto now = ListTracer::now_ns();
+    ListTracer::get().record(m_trace_track, "wait for list", request.trace_id, request.list_id, trace_start, now);
+    output.trace_id = request.trace_id;
+    output.trace_ns = now;
+  }
+
+  if (!m_faults.pass()) {
+    TLOG_DEBUG(TLVL_LIST_GENERATION) << get_name() << ": Injected drop of list " << request.list_id;
     return;
   }
 
+  auto elements = output.list.size();
+  encode(output, m_list_encoding);
+  auto bytes = payload_size(output);
+
+  // A reverser on this host reads the payload from our ring; only the descriptor goes through the connection
+  ShmListRing* ring = nullptr;
+  IntList descriptor;
+  if (m_shm_ring_size > 0 && !request.host.empty() && request.host == m_host) {
+    ring = shm_ring(request.destination);
+    if (ring != nullptr && ring->write(output, m_shm_lease)) {
+      ++m_shm_lists;
+      descriptor = output;
+    } else if (ring != nullptr) {
+      ++m_shm_fallbacks;
+      ring = nullptr;
+    }
+  }
   try {
-    dunedaq::get_iomanager()->get_sender<IntList>(request.destination)->send(std::move(output), m_send_timeout);
+    m_list_senders.send(request.destination, std::move(output), m_send_timeout);
 
     ++m_sent;
-    ++m_sent_tot;
+    m_elements_sent += elements;
+    m_bytes_sent += bytes;
+    m_response_latency.record(std::chrono::steady_clock::now() - received);
   } catch (const dunedaq::iomanager::TimeoutExpired& excpt) {
+    if (ring != nullptr) {
+      ring->release(descriptor);
+    }
     std::ostringstream oss_warn;
     oss_warn << "send to destination \"" << request.destination << "\"";
     ers::warning(dunedaq::iomanager::TimeoutExpired(
@@ -262,6 +541,68 @@ RandomDataListGenerator::process_request_list(const RequestList& request)
   TLOG_DEBUG(TLVL_ENTER_EXIT_METHODS) << get_name() << ": Exiting process_request_list() method";
 }
 
+ShmListRing*
+RandomDataListGenerator::shm_ring(const std::string& destination)
+{
+  std::lock_guard<std::mutex> lk(m_shm_mutex);
+  auto [it, created] = m_shm_rings.emplace(destination, nullptr);
+  if (created) {
+    try {
+      it->second = ShmListRing::create(ShmListRing::ring_name(get_name(), destination), m_shm_ring_size);
+      TLOG() << get_name() << ": passing lists to " << destination << " through shared-memory ring "
+             << it->second->name();
+    } catch (const ShmRingError& excpt) {
+      // Not retried: lists to this destination go through the connection
+      ers::warning(excpt);
+    }
+  }
+  return it->second.get();
+}
+
+void
+RandomDataListGenerator::warm_up()
+{
+  if (m_warmup_lists == 0 || m_replay != nullptr) {
+    return;
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  ListSizeSchedule sizes(m_list_size_seed, m_warmup_min_list_size, m_warmup_max_list_size);
+  for (size_t id = 1; id <= m_warmup_lists; ++id) {
+    std::vector<int> list(sizes.next());
+    fill_list(m_list_mode, id, list, m_parallel);
+    ++m_generated;
+    m_generated_elements += list.size();
+    m_storage.add_list(IntList(id, m_generator_id, list), true);
+  }
+  m_storage_warm = true;
+
+  TLOG() << get_name() << ": pre-generated " << m_warmup_lists << " lists in "
+         << std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count()
+         << " ms";
+}
+
+IntList
+RandomDataListGenerator::replay_list(int list_id)
+{
+  auto it = m_replay_index.find(list_id);
+  auto idx = it != m_replay_index.end() ? it->second
+                                        : m_replay_order[static_cast<size_t>(list_id) % m_replay_order.size()];
+
+  // Copy the elements straight from the mapped file into the message
+  auto view = m_replay->int_list(idx);
+  IntList output;
+  output.list_id = list_id;
+  output.generator_id = m_generator_id;
+  output.list.assign(view.begin(), view.end());
+
+  ++m_generated;
+  m_generated_elements += output.list.size();
+  TLOG_DEBUG(TLVL_LIST_GENERATION) << get_name() << ": Replaying record " << idx << " as list #" << list_id
+                                   << " with size " << output.list.size();
+  return output;
+}
+
 } // namespace listrev
 } // namespace dunedaq
 
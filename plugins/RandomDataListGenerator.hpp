@@ -12,8 +12,20 @@
 #ifndef LISTREV_PLUGINS_RANDOMDATALISTGENERATOR_HPP_
 #define LISTREV_PLUGINS_RANDOMDATALISTGENERATOR_HPP_
 
+#include "FaultInjector.hpp"
+#include "LatencyHistogram.hpp"
+#include "ListFile.hpp"
+#include "ListEncoding.hpp"
+#include "ListKernels.hpp"
+#include "ListSizeSchedule.hpp"
 #include "ListWrapper.hpp"
 #include "ListStorage.hpp"
+#include "RunReport.hpp"
+#include "SenderCache.hpp"
+#include "ShardedCounter.hpp"
+#include "ShmListRing.hpp"
+#include "ThreadPlacement.hpp"
+#include "ListWorkPool.hpp"
 
 #include "listrev/randomdatalistgenerator/Structs.hpp"
 
@@ -23,7 +35,11 @@
 
 #include <ers/Issue.hpp>
 
+#include <atomic>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <set>
 #include <string>
 #include <vector>
 
@@ -68,34 +84,88 @@ private:
   void process_create_list(const CreateList& create_request);
   void process_request_list(const RequestList& request_list);
 
+  // Threading
+  dunedaq::utilities::WorkerThread m_heartbeat_thread;
+  /**
+   * @brief Announce this generator on the heartbeat output every m_heartbeat_interval
+   */
+  void send_heartbeats(std::atomic<bool>& running_flag);
+  void send_heartbeat(bool withdraw);
+
+  /**
+   * @brief Build the list to send for list_id from the replay file: the list this generator recorded with that id if
+   * there is one, otherwise the recorded lists are served in file order
+   */
+  IntList replay_list(int list_id);
+
+  /**
+   * @brief Pre-generate lists 1..m_warmup_lists into storage, with the sizes the validator's ListCreator will use.
+   * Called at conf, and at start when the previous stop flushed the storage.
+   */
+  void warm_up();
+
+  /**
+   * @brief The shared-memory ring for lists to destination, created on first use; nullptr if it cannot be created
+   */
+  ShmListRing* shm_ring(const std::string& destination);
+
   // Init
-  std::string m_request_connection;
+  std::vector<std::string> m_request_connections;
   std::string m_create_connection;
+  std::set<std::string> m_list_connections;
+  std::string m_heartbeat_connection; ///< Empty if the generator does not announce itself
 
   // Configuration
-
-  enum class ListMode : uint16_t
-  {
-    Random = 0,
-    Ascending = 1,
-    Evens = 2,
-    Odds = 3,
-    Descending = 4,
-    MAX = Descending,
-  };
   ListMode m_list_mode{ ListMode::Random };
   std::chrono::milliseconds m_send_timeout{ 100 };
   std::chrono::milliseconds m_request_timeout{ 100 };
   size_t m_generator_id{ 0 };
+  std::chrono::milliseconds m_heartbeat_interval{ 1000 };
+  size_t m_warmup_lists{ 0 };
+  int m_warmup_min_list_size{ 50 };
+  int m_warmup_max_list_size{ 200 };
+  uint32_t m_list_size_seed{ 0 }; // NOLINT(build/unsigned)
+  uint32_t m_trace_track{ 0 };    // NOLINT(build/unsigned)
+  ListEncoding m_list_encoding{ ListEncoding::None };
+  ThreadPlacement m_callback_placement;
+  ParallelPolicy m_parallel;
+  FaultInjector m_faults; ///< Applied to each list just before it is sent
 
   // Data
   ListStorage m_storage;
+  bool m_storage_warm{ false }; ///< Storage holds the warm-up lists; cleared when stop flushes it
+  std::atomic<bool> m_running{ false };
+
+  // Replay
+  std::unique_ptr<ListFileReader> m_replay;
+  std::map<int, size_t> m_replay_index; ///< list_id to record index
+  std::vector<size_t> m_replay_order;   ///< IntList record indices in file order
+
+  // Senders
+  SenderCache<IntList> m_list_senders;
+
+  // Shared memory
+  size_t m_shm_ring_size{ 0 }; ///< Bytes; 0 if lists always go through the connections
+  std::chrono::milliseconds m_shm_lease{ 1000 };
+  std::string m_host;
+  std::map<std::string, std::unique_ptr<ShmListRing>> m_shm_rings; ///< By destination
+  std::mutex m_shm_mutex;
 
   // Monitoring
-  std::atomic<uint64_t> m_generated{ 0 };     // NOLINT(build/unsigned)
-  std::atomic<uint64_t> m_generated_tot{ 0 }; // NOLINT(build/unsigned)
-  std::atomic<uint64_t> m_sent{ 0 };
-  std::atomic<uint64_t> m_sent_tot {0};
+  ShardedCounter m_generated;
+  ShardedCounter m_generated_elements;
+  ShardedCounter m_sent;
+  ShardedCounter m_elements_sent;
+  ShardedCounter m_bytes_sent;
+  ShardedCounter m_filtered;
+  ShardedCounter m_expired_requests;
+  ShardedCounter m_expired_creates;
+  ShardedCounter m_heartbeats_sent;
+  ShardedCounter m_shm_lists;
+  ShardedCounter m_shm_fallbacks;
+  LatencyHistogram m_response_latency; ///< Request received to list sent, this run
+  RunReport m_run_report{ "RandomDataListGenerator" };
+  std::chrono::steady_clock::time_point m_last_opmon_time{ std::chrono::steady_clock::now() };
 };
 } // namespace listrev
 
@@ -15,14 +15,21 @@
 
 #include "ReversedListValidator.hpp"
 #include "CommonIssues.hpp"
+#include "ListEncoding.hpp"
+#include "ListKernels.hpp"
+#include "ListTrace.hpp"
+#include "ListTransforms.hpp"
+#include "ThreadPlacement.hpp"
 
 #include "appfwk/ModuleConfiguration.hpp"
 #include "confmodel/Connection.hpp"
 #include "iomanager/IOManager.hpp"
 #include "logging/Logging.hpp"
 
+#include <algorithm>
 #include <chrono>
 #include <functional>
+#include <random>
 #include <thread>
 #include <vector>
 
@@ -44,6 +51,7 @@ ReversedListValidator::ReversedListValidator(const std::string& name)
 {
   register_command("start", &ReversedListValidator::do_start);
   register_command("stop", &ReversedListValidator::do_stop);
+  register_command("drain_dataflow", &ReversedListValidator::do_drain);
 }
 
 void
@@ -69,8 +77,23 @@ ReversedListValidator::init(std::shared_ptr<appfwk::ModuleConfiguration> mcfg)
     }
   }
 
+  m_warmup_lists = mdal->get_warmup_lists();
   for (auto gen : mdal->get_generatorSet()->get_generators()) {
     m_generatorIds.push_back(gen->get_generator_id());
+
+    // Warm ids are never announced with a CreateList, so every generator must hold all of them
+    if (gen->get_warmup_lists() < m_warmup_lists) {
+      std::ostringstream oss;
+      oss << "generator " << gen->get_generator_id() << " pre-generates only " << gen->get_warmup_lists()
+          << " of the " << m_warmup_lists << " warm-up lists";
+      throw appfwk::CommandFailed(ERS_HERE, get_name(), "init", oss.str());
+    }
+    if (m_warmup_lists > 0 &&
+        (gen->get_list_size_seed() != mdal->get_list_size_seed() || mdal->get_list_size_seed() == 0 ||
+         gen->get_warmup_min_list_size() != mdal->get_min_list_size() ||
+         gen->get_warmup_max_list_size() != mdal->get_max_list_size())) {
+      ers::warning(WarmupScheduleMismatch(ERS_HERE, get_name(), gen->get_generator_id()));
+    }
   }
   m_num_generators = m_generatorIds.size();
 
@@ -82,12 +105,68 @@ ReversedListValidator::init(std::shared_ptr<appfwk::ModuleConfiguration> mcfg)
   m_send_timeout = std::chrono::milliseconds(mdal->get_send_timeout_ms());
   m_request_timeout = std::chrono::milliseconds(mdal->get_request_timeout_ms());
   m_max_outstanding_requests = mdal->get_max_outstanding_requests();
+  m_use_reverser_credits = mdal->get_use_reverser_credits();
+  m_trace_sample_interval = mdal->get_trace_sample_interval();
+  m_validation_queue_capacity = mdal->get_validation_queue_capacity();
+
+  // Validation workers are created once; they run between start and stop
+  auto validation_threads = static_cast<size_t>(mdal->get_validation_threads());
+  if (m_validation_threads.size() != validation_threads) {
+    m_validation_threads.clear();
+    for (size_t worker = 0; worker < validation_threads; ++worker) {
+      m_validation_threads.emplace_back(new dunedaq::utilities::WorkerThread(
+        [this, worker](std::atomic<bool>& running_flag) { validation_work(worker, running_flag); }));
+    }
+    m_worker_stats.reset(new ValidationWorkerStats[validation_threads]);
+  }
+
+  if (mdal->get_num_partitions() == 0 || mdal->get_partition_index() >= mdal->get_num_partitions()) {
+    std::ostringstream oss;
+    oss << "partition_index " << mdal->get_partition_index() << " is not below num_partitions "
+        << mdal->get_num_partitions();
+    throw appfwk::CommandFailed(ERS_HERE, get_name(), "init", oss.str());
+  }
+  m_partition = ListIdPartition(mdal->get_partition_mode() == "range" ? ListIdPartition::Mode::Range
+                                                                      : ListIdPartition::Mode::Stride,
+                                mdal->get_partition_index(),
+                                mdal->get_num_partitions(),
+                                mdal->get_partition_range_size());
+  if (mdal->get_num_partitions() > 1) {
+    TLOG() << get_name() << " owns list id " << m_partition.describe();
+  }
 
-  m_list_creator =
-    ListCreator(m_create_connection,
-                m_send_timeout,
-                mdal->get_min_list_size(),
-                mdal->get_max_list_size());
+  try {
+    m_callback_placement.configure(mdal->get_callback_cpus(), mdal->get_local_memory());
+    m_worker_placement.configure(mdal->get_worker_cpus(), mdal->get_local_memory());
+  } catch (const ThreadPlacementError& excpt) {
+    throw appfwk::CommandFailed(ERS_HERE, get_name(), "init", "Invalid thread placement", excpt);
+  }
+  m_parallel = shared_pool_policy(mdal->get_parallel_threads(), mdal->get_parallel_threshold());
+  try {
+    m_faults.configure(mdal->get_fault_injection(), get_name());
+  } catch (const FaultInjectionError& excpt) {
+    throw appfwk::CommandFailed(ERS_HERE, get_name(), "init", "Invalid fault injection", excpt);
+  }
+  if (m_faults.active()) {
+    ers::info(ProgressUpdate(ERS_HERE, get_name(), "injecting faults: " + m_faults.describe()));
+  }
+
+  if (!mdal->get_trace_path().empty()) {
+    try {
+      ListTracer::get().enable(mdal->get_trace_path());
+    } catch (const TraceFileError& excpt) {
+      throw appfwk::CommandFailed(ERS_HERE, get_name(), "init", "Unable to create the trace file", excpt);
+    }
+  }
+  m_trace_track = ListTracer::get().track(get_name());
+  // Trace ids are (random prefix, list id), so that the lists of several validators in a session stay apart
+  m_trace_prefix = static_cast<uint64_t>(std::random_device()() | 1) << 32;
+
+  m_list_creator = std::make_unique<ListCreator>(m_create_connection,
+                                                 m_send_timeout,
+                                                 mdal->get_min_list_size(),
+                                                 mdal->get_max_list_size(),
+                                                 mdal->get_list_size_seed());
 
   TLOG_DEBUG(TLVL_ENTER_EXIT_METHODS) << get_name() << ": Exiting init() method";
 }
@@ -97,16 +176,83 @@ ReversedListValidator::generate_opmon_data()
 {
   opmon::ReversedListValidatorInfo fcr;
 
-  fcr.set_total_requests(m_requests_total.load());
-  fcr.set_new_requests(m_new_requests.exchange(0));
-  fcr.set_total_lists(m_total_lists.load());
-  fcr.set_new_lists(m_new_lists.exchange(0));
-  fcr.set_total_valid_pairs(m_total_valid_pairs.load());
-  fcr.set_valid_list_pairs(m_valid_list_pairs.exchange(0));
-  fcr.set_total_invalid_pairs(m_total_invalid_pairs.load());
-  fcr.set_invalid_list_pairs(m_invalid_list_pairs.exchange(0));
+  auto now = std::chrono::steady_clock::now();
+  double interval_s = std::chrono::duration<double>(now - m_last_opmon_time).count();
+  m_last_opmon_time = now;
+
+  auto requests = m_requests.snapshot();
+  auto lists = m_lists.snapshot();
+  auto valid_pairs = m_valid_pairs.snapshot();
+  auto invalid_pairs = m_invalid_pairs.snapshot();
+  auto elements = m_elements.snapshot();
+  auto bytes = m_bytes.snapshot();
+
+  fcr.set_total_requests(requests.total);
+  fcr.set_new_requests(requests.delta);
+  fcr.set_total_lists(lists.total);
+  fcr.set_new_lists(lists.delta);
+  fcr.set_total_valid_pairs(valid_pairs.total);
+  fcr.set_valid_list_pairs(valid_pairs.delta);
+  fcr.set_total_invalid_pairs(invalid_pairs.total);
+  fcr.set_invalid_list_pairs(invalid_pairs.delta);
+
+  fcr.set_total_elements(elements.total);
+  fcr.set_new_elements(elements.delta);
+  fcr.set_total_bytes(bytes.total);
+  fcr.set_new_bytes(bytes.delta);
+
+  auto completed = m_completed.snapshot();
+  auto latency_us = m_latency_us.snapshot();
+  auto timed_out = m_timed_out.snapshot();
+  auto late_lists = m_late_lists.snapshot();
+  auto credit_stalls = m_credit_stalls.snapshot();
+  fcr.set_outstanding_requests(m_request_window.outstanding());
+  fcr.set_total_timed_out_requests(timed_out.total);
+  fcr.set_new_timed_out_requests(timed_out.delta);
+  fcr.set_total_late_lists(late_lists.total);
+  fcr.set_new_late_lists(late_lists.delta);
+  fcr.set_total_credit_stalls(credit_stalls.total);
+  fcr.set_new_credit_stalls(credit_stalls.delta);
+  auto validation_overflows = m_validation_overflows.snapshot();
+  if (m_validation_queue != nullptr) {
+    fcr.set_validation_queue_depth(m_validation_queue->get_num_elements());
+  }
+  fcr.set_total_validation_queue_overflows(validation_overflows.total);
+  fcr.set_new_validation_queue_overflows(validation_overflows.delta);
+  if (completed.delta > 0) {
+    fcr.set_average_latency_us(static_cast<double>(latency_us.delta) / completed.delta);
+  }
+  if (interval_s > 0) {
+    fcr.set_elements_per_second(elements.delta / interval_s);
+    fcr.set_bytes_per_second(bytes.delta / interval_s);
+  }
 
   publish(std::move(fcr));
+  if (m_faults.active()) {
+    publish(m_faults.generate_opmon_data());
+  }
+
+  m_generator_breakdown.generate_opmon_data([&](int id, opmon::ListSourceInfo&& info) {
+    publish(std::move(info), { { "generator", std::to_string(id) } });
+  });
+  m_reverser_breakdown.generate_opmon_data([&](int id, opmon::ListSourceInfo&& info) {
+    publish(std::move(info), { { "reverser", std::to_string(id) } });
+  });
+  for (size_t worker = 0; worker < m_validation_threads.size(); ++worker) {
+    opmon::ValidationWorkerInfo winfo;
+    auto busy_ns = m_worker_stats[worker].busy_ns.snapshot();
+    winfo.set_lists(m_worker_stats[worker].lists.snapshot().delta);
+    if (interval_s > 0) {
+      winfo.set_utilization(busy_ns.delta / (interval_s * 1e9));
+    }
+    publish(std::move(winfo), { { "worker", std::to_string(worker) } });
+  }
+
+  auto publish_stats = [&](const std::string& conn, SendStatistics& stats) {
+    publish(stats.generate_opmon_data(), { { "connection", conn } });
+  };
+  m_list_creator->senders().for_each(publish_stats);
+  m_request_senders.for_each(publish_stats);
 }
 
 
@@ -115,7 +261,38 @@ ReversedListValidator::do_start(const nlohmann::json& /*args*/)
 {
   TLOG_DEBUG(TLVL_ENTER_EXIT_METHODS) << get_name() << ": Entering do_start() method";
   m_next_id = 0;
+  m_drained = false;
+  m_request_window.reset(m_max_outstanding_requests, m_next_id + 1);
+  m_reverser_credits.reset(m_num_reversers);
+  m_next_reverser = 0;
+  m_credit_stalled = false;
+  m_latency.reset();
+  m_run_report.start({ &m_requests, &m_lists, &m_completed, &m_valid_pairs, &m_invalid_pairs, &m_elements, &m_bytes,
+                       &m_timed_out, &m_late_lists, &m_credit_stalls, &m_validation_overflows });
+  // Report every configured generator, even one that never delivers a list
+  for (auto gen_id : m_generatorIds) {
+    m_generator_breakdown.record(gen_id, 0, 0, 0);
+  }
+  if (m_callback_placement.active() || m_worker_placement.active()) {
+    ers::info(ProgressUpdate(ERS_HERE,
+                             get_name(),
+                             "worker thread to be placed on " + m_worker_placement.describe() +
+                               ", callback threads on " + m_callback_placement.describe()));
+  }
+  m_list_creator->start();
+  m_reverser_senders.clear();
+  for (auto& conn : m_reveserIds) {
+    m_reverser_senders.push_back(m_request_senders.resolve(conn));
+  }
   m_work_thread.start_working_thread();
+  if (!m_validation_threads.empty()) {
+    m_validation_queue.reset(
+      new iomanager::FollyMPMCQueue<ValidationItem>(get_name() + "_validation", m_validation_queue_capacity));
+    m_validation_pending = 0;
+    for (size_t worker = 0; worker < m_validation_threads.size(); ++worker) {
+      m_validation_threads[worker]->start_working_thread("validate-" + std::to_string(worker));
+    }
+  }
   get_iomanager()->add_callback<ReversedList>(
     m_list_connection,
     std::bind(&ReversedListValidator::process_list, this, std::placeholders::_1));
@@ -127,33 +304,108 @@ void
 ReversedListValidator::do_stop(const nlohmann::json& /*args*/)
 {
   TLOG_DEBUG(TLVL_ENTER_EXIT_METHODS) << get_name() << ": Entering do_stop() method";
-  m_work_thread.stop_working_thread();
-
-  std::chrono::milliseconds stop_timeout(10000);
-  auto stop_wait = std::chrono::steady_clock::now();
-  size_t outstanding_wait = 1;
-  while (outstanding_wait > 0 && std::chrono::duration_cast<std::chrono::milliseconds>(
-                                       std::chrono::steady_clock::now() - stop_wait) < stop_timeout) {
-    std::this_thread::sleep_for(std::chrono::milliseconds(10));
-    std::lock_guard<std::mutex> lk(m_outstanding_id_mutex);
-    outstanding_wait = m_outstanding_ids.size();
-  }
+  drain();
 
-  TLOG() << get_name() << " Removing callback, there are " << outstanding_wait << " requests left outstanding.";
+  TLOG() << get_name() << " Removing callback, " << m_abandoned_requests << " requests were abandoned in the drain.";
 
   get_iomanager()->remove_callback<ReversedList>(m_list_connection);
+  // The workers empty the queue before they exit
+  for (auto& thread : m_validation_threads) {
+    thread->stop_working_thread();
+  }
+  m_list_creator->stop();
+  m_reverser_senders.clear();
+  m_request_senders.clear();
+  ListTracer::get().flush();
   TLOG() << get_name() << " successfully stopped";
 
   
   std::ostringstream oss_summ;
-  oss_summ << ": Exiting do_stop() method, received " << m_total_lists.load() << " reversed list messages, "
-           << "compared " << m_total_valid_pairs.load() + m_total_invalid_pairs.load()
-           << " reversed lists to their original data, and found " << m_total_invalid_pairs.load() << " mismatches. ";
+  oss_summ << ": Exiting do_stop() method, received " << m_lists.total() << " reversed list messages, "
+           << "compared " << m_valid_pairs.total() + m_invalid_pairs.total()
+           << " reversed lists to their original data, and found " << m_invalid_pairs.total() << " mismatches. "
+           << m_timed_out.total() << " requests timed out. Drained in " << m_drain_time.count() << " ms, abandoning "
+           << m_abandoned_requests << " outstanding requests; reversers dropped " << m_reverser_dropped
+           << " incomplete list sets. " << m_validation_overflows.total()
+           << " list sets were discarded because the validation queue was full.";
   ers::info(ProgressUpdate(ERS_HERE, get_name(), oss_summ.str()));
 
+  m_run_report.stop();
+  m_run_report.add_count("requests", m_requests);
+  m_run_report.add_count("list_sets_completed", m_completed);
+  m_run_report.add_rate("list_sets_per_s", m_completed);
+  m_run_report.add_count("lists_received", m_lists);
+  m_run_report.add_rate("elements_per_s", m_elements);
+  m_run_report.add_rate("bytes_per_s", m_bytes);
+  m_run_report.add_latency("latency", m_latency);
+  m_run_report.add_count("valid_pairs", m_valid_pairs);
+  m_run_report.add_count("mismatches", m_invalid_pairs);
+  m_run_report.add_count("timeouts", m_timed_out);
+  m_run_report.add_count("late_lists", m_late_lists);
+  m_run_report.add_count("credit_stalls", m_credit_stalls);
+  m_run_report.add_count("validation_overflows", m_validation_overflows);
+  m_run_report.add("abandoned_requests", m_abandoned_requests);
+  m_run_report.add("reverser_dropped_list_sets", m_reverser_dropped);
+  ers::info(EndOfRunReport(ERS_HERE, get_name(), m_run_report.str(get_name())));
+
   TLOG_DEBUG(TLVL_ENTER_EXIT_METHODS) << get_name() << ": Exiting do_stop() method";
 }
 
+void
+ReversedListValidator::do_drain(const nlohmann::json& /*args*/)
+{
+  TLOG_DEBUG(TLVL_ENTER_EXIT_METHODS) << get_name() << ": Entering do_drain() method";
+  drain();
+  TLOG_DEBUG(TLVL_ENTER_EXIT_METHODS) << get_name() << ": Exiting do_drain() method";
+}
+
+void
+ReversedListValidator::drain()
+{
+  if (m_drained) {
+    return;
+  }
+  m_drained = true;
+
+  if (m_work_thread.thread_running()) {
+    m_work_thread.stop_working_thread();
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  {
+    std::lock_guard<std::mutex> lk(m_drain_mutex);
+    m_drain_acks = 0;
+    m_reverser_dropped = 0;
+  }
+  for (size_t idx = 0; idx < m_reverser_senders.size(); ++idx) {
+    RequestList end_of_requests(m_partition.list_id(m_next_id), m_list_connection);
+    end_of_requests.end_of_requests = true;
+    try {
+      SenderCache<RequestList>::send(m_reverser_senders[idx], std::move(end_of_requests), m_send_timeout);
+    } catch (const dunedaq::iomanager::TimeoutExpired& excpt) {
+      ers::warning(excpt);
+    }
+  }
+
+  // A reverser sends its acknowledgement after all of its list sets, so once every reverser has answered nothing
+  // else can arrive, and once the validation queue is empty every list set has been accounted for. Reversers wait
+  // at most one request timeout for incomplete list sets.
+  {
+    std::unique_lock<std::mutex> lk(m_drain_mutex);
+    m_drain_cv.wait_until(lk, start + 2 * m_request_timeout + m_send_timeout, [&] {
+      return m_drain_acks >= m_num_reversers && m_validation_pending.load() == 0;
+    });
+  }
+
+  m_abandoned_requests = m_request_window.expire(std::chrono::steady_clock::now(), [](int, size_t) {});
+  m_drain_time = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+
+  std::ostringstream oss_prog;
+  oss_prog << "Drained up to list set #" << m_partition.list_id(m_next_id) << " in " << m_drain_time.count() << " ms, " << m_drain_acks
+           << " of " << m_num_reversers << " reversers acknowledged";
+  ers::info(ProgressUpdate(ERS_HERE, get_name(), oss_prog.str()));
+}
+
 /**
  * @brief Format a std::vector<int> to a stream
  * @param t ostream Instance
@@ -178,11 +430,17 @@ void
 ReversedListValidator::do_work(std::atomic<bool>& running_flag)
 {
   TLOG_DEBUG(TLVL_ENTER_EXIT_METHODS) << get_name() << ": Entering do_work() method";
+  m_worker_placement.place(get_name(), "worker");
   m_request_start = std::chrono::steady_clock::now();
 
   while (running_flag.load()) {
-    TLOG_DEBUG(TLVL_LIST_VALIDATION) << get_name() << ": Locking out id list";
-    std::lock_guard<std::mutex> lk(m_outstanding_id_mutex);
+    TLOG_DEBUG(TLVL_LIST_VALIDATION) << get_name() << ": Expiring old requests";
+    m_request_window.expire(std::chrono::steady_clock::now() - m_request_timeout, [&](int id, size_t reverser) {
+      ++m_timed_out;
+      m_reverser_credits.finished(reverser);
+      ers::warning(RequestTimedOut(
+        ERS_HERE, get_name(), m_partition.list_id(id), m_reveserIds[reverser], m_request_timeout.count()));
+    });
 
     TLOG_DEBUG(TLVL_LIST_VALIDATION) << get_name() << ": Sending new requests";
     auto next_req_time = [&]() { 
@@ -191,12 +449,40 @@ ReversedListValidator::do_work(std::atomic<bool>& running_flag)
       return m_request_start + std::chrono::milliseconds(static_cast<int>(off));
     };
 
-    while (m_outstanding_ids.size() < m_max_outstanding_requests && std::chrono::steady_clock::now() > next_req_time()) {
-      m_list_creator.send_create(++m_next_id);
-      m_outstanding_ids[m_next_id] = std::chrono::steady_clock::now();
-      send_request(m_next_id);
-      ++m_requests_total;
-      ++m_new_requests;
+    while (m_request_window.outstanding() < m_max_outstanding_requests && m_request_window.can_insert(m_next_id + 1) &&
+           m_partition.has_sequence(m_next_id + 1) && std::chrono::steady_clock::now() > next_req_time()) {
+      size_t reverser = 0;
+      if (!select_reverser(reverser)) {
+        // Overload shows up as a lower request rate instead of timeouts
+        if (!m_credit_stalled) {
+          m_credit_stalled = true;
+          ++m_credit_stalls;
+        }
+        break;
+      }
+      m_credit_stalled = false;
+
+      // Past this point the request has timed out here, so downstream work on it is wasted
+      auto deadline = deadline_after(m_request_timeout);
+      ++m_next_id;
+      auto list_id = m_partition.list_id(m_next_id);
+      uint64_t trace_id = 0; // NOLINT(build/unsigned)
+      auto trace_start = ListTracer::now_ns();
+      if (m_trace_sample_interval > 0 && m_next_id % m_trace_sample_interval == 0) {
+        trace_id = m_trace_prefix | static_cast<uint32_t>(list_id); // NOLINT(build/unsigned)
+      }
+      if (static_cast<size_t>(list_id) <= m_warmup_lists) {
+        m_list_creator->skip_create(list_id);
+      } else {
+        m_list_creator->send_create(list_id, deadline, trace_id);
+      }
+      m_request_window.insert(m_next_id, reverser, std::chrono::steady_clock::now());
+      m_reverser_credits.sent(reverser);
+      send_request(list_id, reverser, deadline, trace_id);
+      if (trace_id != 0) {
+        ListTracer::get().record(m_trace_track, "request", trace_id, list_id, trace_start, ListTracer::now_ns());
+      }
+      ++m_requests;
     }
 
     TLOG_DEBUG(TLVL_LIST_VALIDATION) << get_name() << ": End of do_work loop";
@@ -206,68 +492,274 @@ ReversedListValidator::do_work(std::atomic<bool>& running_flag)
 }
 
 void
-ReversedListValidator::process_list(const ReversedList& list)
+ReversedListValidator::process_list(ReversedList& message)
 {
   TLOG_DEBUG(TLVL_ENTER_EXIT_METHODS) << get_name() << ": Entering process_list() method";
+  auto received = std::chrono::steady_clock::now();
+  m_callback_placement.place(get_name(), "callback");
+
+  if (message.drain_ack) {
+    std::lock_guard<std::mutex> lk(m_drain_mutex);
+    ++m_drain_acks;
+    m_reverser_dropped += message.dropped_lists;
+    m_drain_cv.notify_all();
+    return;
+  }
 
-  ++m_total_lists;
-  ++m_new_lists;
+  // A dropped list set is timed out like a lost one; a corrupted one must show up as mismatches
+  if (!m_faults.pass()) {
+    return;
+  }
+  ReversedList* list_set = &message;
+  ReversedList corrupted;
+  if (m_faults.corrupts() && !message.lists.empty()) {
+    // Corrupt the decoded elements, since flipping a bit of an encoded list would only make it undecodable. A set
+    // that cannot be decoded is validated as received, and reported as such.
+    corrupted = message;
+    try {
+      decode(corrupted);
+      m_faults.corrupt(corrupted.lists[corrupted.list_id % corrupted.lists.size()].reversed.list);
+      list_set = &corrupted;
+    } catch (const ListEncodingError&) {
+    }
+  }
+
+  if (m_validation_threads.empty()) {
+    ListCompletion completion;
+    if (validate_list(*list_set, received, completion)) {
+      complete_list(completion);
+    }
+  } else {
+    // Hand the list set over without copying it, and without waiting for room, so that this thread can go back to
+    // receiving at once
+    auto list_id = message.list_id;
+    auto reverser_id = message.reverser_id;
+    ++m_validation_pending;
+    if (!m_validation_queue->try_push(ValidationItem{ std::move(*list_set), received }, std::chrono::milliseconds(0))) {
+      --m_validation_pending;
+      ++m_validation_overflows;
+      ers::warning(ValidationQueueFull(ERS_HERE, get_name(), list_id, reverser_id));
+    }
+  }
+
+  TLOG_DEBUG(TLVL_ENTER_EXIT_METHODS) << get_name() << ": Exiting process_list() method";
+}
+
+void
+ReversedListValidator::validation_work(size_t worker, std::atomic<bool>& running_flag)
+{
+  TLOG_DEBUG(TLVL_ENTER_EXIT_METHODS) << get_name() << ": Entering validation_work() method";
+  m_callback_placement.place(get_name(), "validation worker");
+  auto& stats = m_worker_stats[worker];
+  std::vector<ListCompletion> completions;
+  completions.reserve(s_completion_batch);
+  ValidationItem item;
+
+  while (true) {
+    if (!m_validation_queue->try_pop(item, std::chrono::milliseconds(10))) {
+      if (!running_flag.load()) {
+        break;
+      }
+      continue;
+    }
+
+    // Take whatever else is already queued, up to a batch, and complete the requests together
+    auto start = std::chrono::steady_clock::now();
+    size_t batch = 0;
+    do {
+      ListCompletion completion;
+      if (validate_list(item.list, item.received, completion)) {
+        completions.push_back(completion);
+      }
+      ++batch;
+    } while (batch < s_completion_batch && m_validation_queue->try_pop(item, std::chrono::milliseconds(0)));
+    for (auto& completion : completions) {
+      complete_list(completion);
+    }
+    completions.clear();
+
+    stats.lists += batch;
+    stats.busy_ns +=
+      std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+    if (m_validation_pending.fetch_sub(batch) == batch) {
+      std::lock_guard<std::mutex> lk(m_drain_mutex);
+      m_drain_cv.notify_all();
+    }
+  }
+
+  TLOG_DEBUG(TLVL_ENTER_EXIT_METHODS) << get_name() << ": Exiting validation_work() method";
+}
+
+bool
+ReversedListValidator::validate_list(const ReversedList& message,
+                                     std::chrono::steady_clock::time_point received,
+                                     ListCompletion& completion)
+{
+  ReversedList scratch;
+  const ReversedList* decoded_list = &message;
+  try {
+    decoded_list = &decoded(message, scratch);
+  } catch (const ListEncodingError& excpt) {
+    ers::error(excpt);
+    return false;
+  }
+  auto& list = *decoded_list;
+
+  if (!m_partition.contains(list.list_id)) {
+    ers::warning(ListOutsidePartition(ERS_HERE, get_name(), list.list_id, list.reverser_id, m_partition.describe()));
+    return false;
+  }
+
+  ++m_lists;
+  ListTracer::get().hop(m_trace_track, "reversed list transit", list);
+  auto trace_start = ListTracer::now_ns();
+
+  size_t list_elements = 0;
+  for (auto& list_data : list.lists) {
+    list_elements += list_data.original.list.size();
+    m_generator_breakdown.record(list_data.original.generator_id,
+                                 1,
+                                 list_data.original.list.size(),
+                                 payload_size(list_data.original) + payload_size(list_data.reversed));
+  }
+  auto list_bytes = payload_size(message);
+  m_reverser_breakdown.record(list.reverser_id, 1, list_elements, list_bytes);
+  m_elements += list_elements;
+  m_bytes += list_bytes;
 
   std::ostringstream oss_prog;
   oss_prog << "Validating list set #" << list.list_id << " from reverser " << list.reverser_id << ". ";
   ers::debug(ProgressUpdate(ERS_HERE, get_name(), oss_prog.str()));
 
-  if (list.lists.size() != m_num_generators) {
-    ers::error(MissingListError(ERS_HERE, get_name(), list.list_id, m_num_generators, list.lists.size()));  
+  // A reverser that follows generator heartbeats says how many generators it asked; otherwise all of them were
+  size_t expected_lists = list.expected_lists > 0 ? list.expected_lists : m_num_generators;
+  if (list.lists.size() != expected_lists) {
+    std::ostringstream missing;
+    if (list.expected_lists > 0) {
+      missing << "not known, the reverser follows generator heartbeats";
+    } else {
+      for (auto gen_id : m_generatorIds) {
+        if (std::none_of(list.lists.begin(), list.lists.end(), [&](const ReversedList::Data& data) {
+              return data.original.generator_id == static_cast<int>(gen_id);
+            })) {
+          missing << (missing.tellp() > 0 ? "," : "") << gen_id;
+        }
+      }
+    }
+    ers::error(MissingListError(ERS_HERE,
+                                get_name(),
+                                list.list_id,
+                                expected_lists,
+                                list.lists.size(),
+                                missing.tellp() > 0 ? missing.str() : "none"));
+  }
+
+  // A list set from a ListTransformer records the kernels it applied
+  TransformChain transforms;
+  bool known_transforms = true;
+  try {
+    transforms = TransformChain::from_codes(list.transforms);
+  } catch (const ListTransformError& excpt) {
+    ers::error(excpt);
+    known_transforms = false;
+    m_invalid_pairs += list.lists.size();
   }
 
   for (auto& list_data : list.lists) {
+    if (!known_transforms) {
+      break;
+    }
 
     std::ostringstream oss_prog;
-    oss_prog << "Validating list #" << list.list_id << " from generator " << list_data.original.generator_id << ", original contents " << list_data.original.list
-             << " and reversed contents " << list_data.reversed.list << ". ";
+    oss_prog << "Validating list #" << list.list_id << " from generator " << list_data.original.generator_id
+             << ", original size " << list_data.original.list.size() << " and reversed size "
+             << list_data.reversed.list.size() << ". ";
     ers::debug(ProgressUpdate(ERS_HERE, get_name(), oss_prog.str()));
 
-    TLOG_DEBUG(TLVL_LIST_VALIDATION)
-      << get_name() << ": Re-reversing the reversed list so that it can be compared to the original list";
-    auto reversed = list_data.reversed.list;
-    std::reverse(reversed.begin(), reversed.end());
-
-    TLOG_DEBUG(TLVL_LIST_VALIDATION) << get_name() << ": Comparing the doubly-reversed list with the original list";
-    if (reversed != list_data.original.list) {
+    TLOG_DEBUG(TLVL_LIST_VALIDATION) << get_name() << ": Comparing the reversed list with the original list";
+    if (!transforms.empty()) {
+      if (transforms.check(list_data.original.list, list_data.reversed.list)) {
+        ++m_valid_pairs;
+      } else {
+        std::ostringstream oss_result;
+        oss_result << list_data.reversed.list;
+        std::ostringstream oss_orig;
+        oss_orig << list_data.original.list;
+        ers::error(TransformMismatchError(
+          ERS_HERE, get_name(), list.list_id, transforms.describe(), oss_result.str(), oss_orig.str()));
+        ++m_invalid_pairs;
+      }
+    } else if (!is_reversal(list_data.original, list_data.reversed, m_parallel)) {
+      auto reversed = list_data.reversed.list;
+      std::reverse(reversed.begin(), reversed.end());
       std::ostringstream oss_rev;
       oss_rev << reversed;
       std::ostringstream oss_orig;
       oss_orig << list_data.original.list;
       ers::error(DataMismatchError(ERS_HERE, get_name(), list.list_id, oss_rev.str(), oss_orig.str()));
-      ++m_invalid_list_pairs;
-      ++m_total_invalid_pairs;
+      ++m_invalid_pairs;
     } else {
-      ++m_valid_list_pairs;
-      ++m_total_valid_pairs;
+      ++m_valid_pairs;
     }
   }
 
-  std::lock_guard<std::mutex> lk(m_outstanding_id_mutex);
-  m_outstanding_ids.erase(list.list_id);
+  if (list.trace_id != 0) {
+    ListTracer::get().record(m_trace_track, "validate", list.trace_id, list.list_id, trace_start, ListTracer::now_ns());
+  }
 
-  TLOG_DEBUG(TLVL_ENTER_EXIT_METHODS) << get_name() << ": Exiting process_list() method";
+  completion = ListCompletion{ m_partition.sequence(list.list_id), received, list.credits, list.credit_requests };
+  return true;
 }
 
 void
-ReversedListValidator::send_request(int id)
+ReversedListValidator::complete_list(const ListCompletion& completion)
 {
-  TLOG_DEBUG(TLVL_ENTER_EXIT_METHODS) << get_name() << ": Entering send_request() method";
+  auto result = m_request_window.complete(completion.sequence, completion.received);
+  if (result.status == RequestWindow::CompletionStatus::Completed) {
+    m_reverser_credits.finished(result.reverser);
+    m_reverser_credits.grant(result.reverser, completion.credits, completion.credit_requests);
+    ++m_completed;
+    m_latency_us += std::chrono::duration_cast<std::chrono::microseconds>(result.latency).count();
+    m_latency.record(result.latency);
+  } else if (result.status == RequestWindow::CompletionStatus::Late) {
+    ++m_late_lists;
+  }
+}
 
-  auto reverser_id = id % m_num_reversers;
+bool
+ReversedListValidator::select_reverser(size_t& reverser)
+{
+  if (!m_use_reverser_credits) {
+    reverser = (m_next_id + 1) % m_num_reversers;
+    return true;
+  }
+
+  for (size_t idx = 0; idx < m_num_reversers; ++idx) {
+    auto candidate = (m_next_reverser + idx) % m_num_reversers;
+    if (m_reverser_credits.has_credit(candidate)) {
+      reverser = candidate;
+      m_next_reverser = candidate + 1;
+      return true;
+    }
+  }
+  return false;
+}
+
+void
+ReversedListValidator::send_request(int id, size_t reverser_id, int64_t deadline_ns, uint64_t trace_id)
+{
+  TLOG_DEBUG(TLVL_ENTER_EXIT_METHODS) << get_name() << ": Entering send_request() method";
 
   RequestList req;
   req.list_id = id;
   req.destination = m_list_connection;
+  req.deadline_ns = deadline_ns;
+  if (trace_id != 0) {
+    req.trace_id = trace_id;
+    req.trace_ns = ListTracer::now_ns();
+  }
 
-  get_iomanager()
-    ->get_sender<RequestList>(m_reveserIds[reverser_id])
-    ->send(std::move(req), m_send_timeout);
+  SenderCache<RequestList>::send(m_reverser_senders[reverser_id], std::move(req), m_send_timeout);
 
   TLOG_DEBUG(TLVL_ENTER_EXIT_METHODS) << get_name() << ": Exiting send_request() method";
 }
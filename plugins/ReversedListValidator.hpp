@@ -17,15 +17,29 @@
 #include "ListWrapper.hpp"
 #include "ListStorage.hpp"
 #include "ListCreator.hpp"
+#include "ListIdPartition.hpp"
+#include "CreditTracker.hpp"
+#include "RequestWindow.hpp"
+#include "SenderCache.hpp"
+#include "ShardedCounter.hpp"
+#include "SourceBreakdown.hpp"
+#include "ThreadPlacement.hpp"
+#include "ListWorkPool.hpp"
+#include "FaultInjector.hpp"
+#include "LatencyHistogram.hpp"
+#include "RunReport.hpp"
 
 #include "appfwk/DAQModule.hpp"
 #include "iomanager/Receiver.hpp"
 #include "iomanager/Sender.hpp"
+#include "iomanager/queue/FollyQueue.hpp"
 #include "utilities/WorkerThread.hpp"
 
 #include <ers/Issue.hpp>
 
+#include <condition_variable>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -60,23 +74,81 @@ private:
   // Commands
   void do_start(const nlohmann::json& obj);
   void do_stop(const nlohmann::json& obj);
+  void do_drain(const nlohmann::json& obj);
 
   // Threading
   dunedaq::utilities::WorkerThread m_work_thread;
   void do_work(std::atomic<bool>&);
+  std::vector<std::unique_ptr<dunedaq::utilities::WorkerThread>> m_validation_threads;
+  /**
+   * @brief Validate list sets from the validation queue until stopped and the queue is empty
+   */
+  void validation_work(size_t worker, std::atomic<bool>& running_flag);
 
   // Callbacks
-  void process_list(const ReversedList& list);
+  void process_list(ReversedList& list);
+
+  /// A received list set waiting in the validation queue
+  struct ValidationItem
+  {
+    ReversedList list;
+    std::chrono::steady_clock::time_point received;
+  };
+  /// The outcome of a validated list set for its request
+  struct ListCompletion
+  {
+    int sequence;
+    std::chrono::steady_clock::time_point received;
+    int credits;
+    uint64_t credit_requests; // NOLINT(build/unsigned)
+  };
+  static constexpr size_t s_completion_batch = 16; ///< Most list sets a worker validates before completing them
+
+  /**
+   * @brief Validate one list set
+   * @return Whether completion has been filled in, i.e. the list set answers one of this validator's requests
+   */
+  bool validate_list(const ReversedList& message,
+                     std::chrono::steady_clock::time_point received,
+                     ListCompletion& completion);
+  void complete_list(const ListCompletion& completion);
 
   // Methods
-  void send_request(int id);
+  void send_request(int id, size_t reverser, int64_t deadline_ns, uint64_t trace_id); // NOLINT(build/unsigned)
+  /**
+   * @brief Choose the reverser for the next request: round-robin, skipping reversers without credit when
+   * use_reverser_credits is set
+   * @return false if no reverser has credit
+   */
+  bool select_reverser(size_t& reverser);
+  /**
+   * @brief Stop issuing requests, send end-of-requests to every reverser and wait for their acknowledgements. Runs
+   * once per run, at drain_dataflow or else at stop.
+   */
+  void drain();
 
   // Data
-  std::map<int,std::chrono::steady_clock::time_point> m_outstanding_ids;
-  int m_next_id{ 0 };
+  RequestWindow m_request_window;
+  CreditTracker m_reverser_credits;
+  size_t m_next_reverser{ 0 };
+  bool m_credit_stalled{ false };
+  std::mutex m_drain_mutex;
+  std::condition_variable m_drain_cv;
+  size_t m_drain_acks{ 0 };
+  size_t m_reverser_dropped{ 0 };
+  size_t m_abandoned_requests{ 0 };
+  std::unique_ptr<iomanager::FollyMPMCQueue<ValidationItem>> m_validation_queue;
+  std::atomic<size_t> m_validation_pending{ 0 }; ///< List sets queued or being validated
+  std::chrono::milliseconds m_drain_time{ 0 };
+  bool m_drained{ false };
+  int m_next_id{ 0 }; ///< Sequence number of the last request; its list id is m_partition.list_id(m_next_id)
+  ListIdPartition m_partition;
   std::chrono::steady_clock::time_point m_request_start;
-  mutable std::mutex m_outstanding_id_mutex;
-  ListCreator m_list_creator;
+  std::unique_ptr<ListCreator> m_list_creator;
+
+  // Senders
+  SenderCache<RequestList> m_request_senders;
+  std::vector<SenderCache<RequestList>::Entry*> m_reverser_senders;
 
   // Init
   std::string m_list_connection;
@@ -89,21 +161,44 @@ private:
   size_t m_num_generators{ 0 };
   size_t m_num_reversers{ 0 };
   size_t m_request_rate_hz{ 100 };
+  size_t m_warmup_lists{ 0 };
+  bool m_use_reverser_credits{ false };
+  size_t m_validation_queue_capacity{ 1000 };
+  size_t m_trace_sample_interval{ 0 };
+  uint64_t m_trace_prefix{ 0 };  // NOLINT(build/unsigned)
+  uint32_t m_trace_track{ 0 };   // NOLINT(build/unsigned)
+  ThreadPlacement m_worker_placement;
+  ThreadPlacement m_callback_placement;
+  ParallelPolicy m_parallel;
+  FaultInjector m_faults; ///< Applied to each received list set
 
   std::vector<uint32_t> m_generatorIds;
   std::vector<std::string> m_reveserIds;
 
   // Monitoring
-  std::atomic<uint64_t> m_requests_total{ 0 };
-  std::atomic<uint64_t> m_new_requests{ 0 };
-  std::atomic<uint64_t> m_total_lists{ 0 };
-  std::atomic<uint64_t> m_new_lists{ 0 };
-  std::atomic<uint64_t> m_total_reversed{ 0 };
-  std::atomic<uint64_t> m_new_reversed{ 0 };
-  std::atomic<uint64_t> m_total_valid_pairs{ 0 };
-  std::atomic<uint64_t> m_valid_list_pairs{ 0 };
-  std::atomic<uint64_t> m_total_invalid_pairs{ 0 };
-  std::atomic<uint64_t> m_invalid_list_pairs{ 0 };
+  ShardedCounter m_requests;
+  ShardedCounter m_lists;
+  ShardedCounter m_valid_pairs;
+  ShardedCounter m_invalid_pairs;
+  ShardedCounter m_elements;
+  ShardedCounter m_bytes;
+  ShardedCounter m_completed;
+  ShardedCounter m_latency_us;
+  LatencyHistogram m_latency; ///< Request to completion, this run
+  ShardedCounter m_timed_out;
+  ShardedCounter m_late_lists;
+  ShardedCounter m_credit_stalls;
+  ShardedCounter m_validation_overflows;
+  struct ValidationWorkerStats
+  {
+    ShardedCounter lists;
+    ShardedCounter busy_ns;
+  };
+  std::unique_ptr<ValidationWorkerStats[]> m_worker_stats;
+  std::chrono::steady_clock::time_point m_last_opmon_time{ std::chrono::steady_clock::now() };
+  SourceBreakdown m_generator_breakdown;
+  SourceBreakdown m_reverser_breakdown;
+  RunReport m_run_report{ "ReversedListValidator" };
 };
 } // namespace listrev
 
@@ -111,9 +206,18 @@ private:
 ERS_DECLARE_ISSUE_BASE(listrev,
                        MissingListError,
                        appfwk::GeneralDAQModuleIssue,
-                       "Missing lists detected, for list set " << id << " expected " << n_gen << " lists, but received only " << n_lists,
+                       "Missing lists detected, for list set " << id << " expected " << n_gen << " lists, but received only " << n_lists
+                         << "; missing generators: " << missing,
+                       ((std::string)name),
+                       ((int)id)((int)n_gen)((int)n_lists)((std::string)missing))
+
+ERS_DECLARE_ISSUE_BASE(listrev,
+                       RequestTimedOut,
+                       appfwk::GeneralDAQModuleIssue,
+                       "List set " << id << " requested from " << reverser << " was not received within "
+                         << timeout_ms << " ms",
                        ((std::string)name),
-                       ((int)id)((int)n_gen)((int)n_lists))
+                       ((int)id)((std::string)reverser)((int)timeout_ms))
 
 ERS_DECLARE_ISSUE_BASE(listrev,
                        DataMismatchError,
@@ -122,6 +226,38 @@ ERS_DECLARE_ISSUE_BASE(listrev,
                          << revContents << ", original list contents = " << origContents,
                        ((std::string)name),
                        ((int)id)((std::string)revContents)((std::string)origContents))
+
+ERS_DECLARE_ISSUE_BASE(listrev,
+                       TransformMismatchError,
+                       appfwk::GeneralDAQModuleIssue,
+                       "Data mismatch when validating list " << id << " transformed by " << kernels
+                                                             << ": result = " << result
+                                                             << ", original list contents = " << origContents,
+                       ((std::string)name),
+                       ((int)id)((std::string)kernels)((std::string)result)((std::string)origContents))
+
+ERS_DECLARE_ISSUE_BASE(listrev,
+                       ValidationQueueFull,
+                       appfwk::GeneralDAQModuleIssue,
+                       "Validation queue full, discarding list set " << id << " from reverser " << reverser,
+                       ((std::string)name),
+                       ((int)id)((int)reverser))
+
+ERS_DECLARE_ISSUE_BASE(listrev,
+                       WarmupScheduleMismatch,
+                       appfwk::GeneralDAQModuleIssue,
+                       "Generator " << generator_id << " pre-generates lists with a different size schedule; "
+                         << "the first lists of a run will not follow min_list_size, max_list_size and list_size_seed",
+                       ((std::string)name),
+                       ((int)generator_id))
+
+ERS_DECLARE_ISSUE_BASE(listrev,
+                       ListOutsidePartition,
+                       appfwk::GeneralDAQModuleIssue,
+                       "Received list set " << id << " from reverser " << reverser << ", which is not in "
+                         << partition << "; it was requested by another validator",
+                       ((std::string)name),
+                       ((int)id)((int)reverser)((std::string)partition))
 // Re-enable coverage collection LCOV_EXCL_STOP
 
 } // namespace dunedaq
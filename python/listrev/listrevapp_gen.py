@@ -32,9 +32,10 @@ def get_listrev_app(
     request_rate_hz=10,
     generator_indicies=[],
     reverser_indicies=[],
-    has_validator=False,
+    validator_indicies=[],
     n_generators=1,
     n_reversers=1,
+    n_validators=1,
     n_ints_min=50,
     n_ints_max=200,
     n_reqs=100,
@@ -67,10 +68,9 @@ def get_listrev_app(
             ) for ridx in reverser_indicies
         ]
 
-    if has_validator:
-        modules += [
+    modules += [
             DAQModule(
-                name="lrv",
+                name=f"lrv{vidx}",
                 plugin="ReversedListValidator",
                 conf=rlv.ConfParams(
                     send_timeout_ms=n_wait_ms,
@@ -80,9 +80,11 @@ def get_listrev_app(
                     num_reversers=n_reversers,
                     num_generators=n_generators,
                     min_list_size=n_ints_min,
-                    max_list_size=n_ints_max
+                    max_list_size=n_ints_max,
+                    partition_index=vidx,
+                    num_partitions=n_validators
                 ),
-            )
+            ) for vidx in validator_indicies
         ]
 
     mgraph = ModuleGraph(modules)
@@ -100,7 +102,9 @@ def get_listrev_app(
 
     for ridx in reverser_indicies:
         mgraph.add_endpoint(f"lr{ridx}_list_connection", f"lr{ridx}.list_input", "IntList", Direction.IN)
-        mgraph.add_endpoint(f"validator_list_connection", f"lr{ridx}.output", "ReversedList", Direction.OUT)
+        # List sets go back to the validator that requested them
+        for vidx in range(n_validators):
+            mgraph.add_endpoint(f"validator{vidx}_list_connection", f"lr{ridx}.output_{vidx}", "ReversedList", Direction.OUT)
         mgraph.add_endpoint(
             f"lr{ridx}_request_connection",
             f"lr{ridx}.request_input",
@@ -111,16 +115,16 @@ def get_listrev_app(
         for gidx in range(n_generators):
             mgraph.add_endpoint(f"rdlg{gidx}_request_connection", f"lr{ridx}.request_output_{gidx}", "RequestList", Direction.OUT)
 
-    if has_validator:
-        mgraph.add_endpoint("validator_list_connection", "lrv.list_input", "ReversedList", Direction.IN)
+    for vidx in validator_indicies:
+        mgraph.add_endpoint(f"validator{vidx}_list_connection", f"lrv{vidx}.list_input", "ReversedList", Direction.IN)
         for ridx in range(n_reversers):
             mgraph.add_endpoint(
                 f"lr{ridx}_request_connection",
-                f"lrv.request_output_{ridx}",
+                f"lrv{vidx}.request_output_{ridx}",
                 "RequestList",
                 Direction.OUT
             )
-        mgraph.add_endpoint(f"creates", "lrv.creates_out", "CreateList", Direction.OUT, is_pubsub=True, toposort=False)
+        mgraph.add_endpoint(f"creates", f"lrv{vidx}.creates_out", "CreateList", Direction.OUT, is_pubsub=True, toposort=False)
 
     lr_app = App(modulegraph=mgraph, host=host, name=nickname)
 
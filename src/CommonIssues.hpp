@@ -27,6 +27,13 @@ ERS_DECLARE_ISSUE_BASE(listrev,
                        ((std::string)name),
                        ((std::string)message))
 
+ERS_DECLARE_ISSUE_BASE(listrev,
+                       EndOfRunReport,
+                       appfwk::GeneralDAQModuleIssue,
+                       "Run report: " << report,
+                       ((std::string)name),
+                       ((std::string)report))
+
 ERS_DECLARE_ISSUE_BASE(listrev,
                        InvalidQueueFatalError,
                        appfwk::GeneralDAQModuleIssue,
@@ -34,6 +41,14 @@ ERS_DECLARE_ISSUE_BASE(listrev,
                        ((std::string)name),
                        ((std::string)queueType))
 
+ERS_DECLARE_ISSUE_BASE(listrev,
+                       GeneratorLost,
+                       appfwk::GeneralDAQModuleIssue,
+                       "Generator " << generator_id << " sent no heartbeat for " << timeout_ms
+                                    << " ms; no longer waiting for its lists",
+                       ((std::string)name),
+                       ((int)generator_id)((int)timeout_ms))
+
 ERS_DECLARE_ISSUE(listrev,
                        ListNotFound,
                        "An IntList with ID " << list_id << " was not found when requested.",
@@ -42,6 +57,34 @@ ERS_DECLARE_ISSUE(listrev,
                        ListExists,
                        "An IntList with ID " << list_id << " already is in storage.",
                        ((int)list_id))
+ERS_DECLARE_ISSUE(listrev,
+                       ListFileError,
+                       "List file " << path << ": " << reason,
+                       ((std::string)path)((std::string)reason))
+ERS_DECLARE_ISSUE(listrev,
+                       ListEncodingError,
+                       "List encoding: " << reason,
+                       ((std::string)reason))
+ERS_DECLARE_ISSUE(listrev,
+                       ListTransformError,
+                       "List transform: " << reason,
+                       ((std::string)reason))
+ERS_DECLARE_ISSUE(listrev,
+                       FaultInjectionError,
+                       "Fault injection: " << reason,
+                       ((std::string)reason))
+ERS_DECLARE_ISSUE(listrev,
+                       ShmRingError,
+                       "Shared-memory ring " << ring << ": " << reason,
+                       ((std::string)ring)((std::string)reason))
+ERS_DECLARE_ISSUE(listrev,
+                       ThreadPlacementError,
+                       "Thread placement: " << reason,
+                       ((std::string)reason))
+ERS_DECLARE_ISSUE(listrev,
+                       TraceFileError,
+                       "Trace file " << path << ": " << reason,
+                       ((std::string)path)((std::string)reason))
 // Re-enable coverage collection LCOV_EXCL_STOP
 
 } // namespace dunedaq
@@ -0,0 +1,116 @@
+/**
+ * @file CreditTracker.hpp
+ *
+ * CreditTracker keeps the validator's view of the credits granted by each
+ * reverser. A reverser advertises, with every list set it returns, how many
+ * more list sets it can hold, and how many of this validator's requests it
+ * had received when it counted them. The validator may send that many
+ * requests beyond the ones the reverser had not seen yet.
+ *
+ * grant() and finished() are called from the list callback or the validation
+ * workers, sent() and has_credit() from the request thread; the counters are
+ * atomic and the view is allowed to be momentarily stale.
+ *
+ * This is part of the DUNE DAQ Software Suite, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#ifndef LISTREV_PLUGINS_CREDITTRACKER_HPP_
+#define LISTREV_PLUGINS_CREDITTRACKER_HPP_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace dunedaq {
+namespace listrev {
+
+class CreditTracker
+{
+public:
+  /**
+   * @brief Forget all grants; every target starts without advertised credits (i.e. unlimited)
+   */
+  void reset(size_t num_targets)
+  {
+    m_targets.reset(new Target[num_targets]);
+    m_size = num_targets;
+  }
+
+  /**
+   * @brief Record the credits advertised by target after it had received requests_received of our requests; a
+   * negative value means the target does not use credits
+   */
+  void grant(size_t target, int credits, uint64_t requests_received) // NOLINT(build/unsigned)
+  {
+    if (target >= m_size) {
+      return;
+    }
+    // List sets can complete out of order; a grant only replaces one that was computed earlier
+    auto& t = m_targets[target];
+    auto update = pack(credits, static_cast<uint32_t>(requests_received)); // NOLINT(build/unsigned)
+    auto current = t.grant.load(std::memory_order_relaxed);
+    while (static_cast<int32_t>(seen(update) - seen(current)) >= 0 &&
+           !t.grant.compare_exchange_weak(current, update, std::memory_order_relaxed)) {
+    }
+  }
+
+  void sent(size_t target)
+  {
+    m_targets[target].sent.fetch_add(1, std::memory_order_relaxed);
+    m_targets[target].in_flight.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief A request to target completed or timed out
+   */
+  void finished(size_t target)
+  {
+    if (target < m_size) {
+      m_targets[target].in_flight.fetch_sub(1, std::memory_order_relaxed);
+    }
+  }
+
+  /**
+   * @brief Whether another request may be sent to target. A target with nothing in flight always gets one, so that a
+   * target which granted no credit is probed again instead of being starved forever.
+   */
+  bool has_credit(size_t target) const
+  {
+    auto& t = m_targets[target];
+    auto grant = t.grant.load(std::memory_order_relaxed);
+    auto credits = granted(grant);
+    // Requests the target had not received when it granted the credits are still on their way to it
+    auto unseen = static_cast<uint32_t>(t.sent.load(std::memory_order_relaxed) - seen(grant)); // NOLINT
+    return credits < 0 || static_cast<int64_t>(credits) - unseen > 0 ||
+           t.in_flight.load(std::memory_order_relaxed) <= 0;
+  }
+
+  int in_flight(size_t target) const { return m_targets[target].in_flight.load(std::memory_order_relaxed); }
+
+private:
+  /// Credits in the low half, the target's count of received requests (modulo 2^32) in the high half
+  static uint64_t pack(int credits, uint32_t seen) // NOLINT(build/unsigned)
+  {
+    return uint64_t{ seen } << 32 | static_cast<uint32_t>(credits); // NOLINT(build/unsigned)
+  }
+  static int granted(uint64_t grant) { return static_cast<int32_t>(grant & 0xffffffff); } // NOLINT(build/unsigned)
+  static uint32_t seen(uint64_t grant) { return static_cast<uint32_t>(grant >> 32); } // NOLINT(build/unsigned)
+
+  struct alignas(64) Target
+  {
+    std::atomic<uint64_t> grant{ pack(-1, 0) }; // NOLINT(build/unsigned)
+    std::atomic<uint32_t> sent{ 0 };            // NOLINT(build/unsigned)
+    std::atomic<int> in_flight{ 0 };
+  };
+
+  std::unique_ptr<Target[]> m_targets;
+  size_t m_size{ 0 };
+};
+
+} // namespace listrev
+} // namespace dunedaq
+
+#endif // LISTREV_PLUGINS_CREDITTRACKER_HPP_
@@ -0,0 +1,179 @@
+/**
+ * @file FaultInjector.cpp FaultInjector implementation
+ *
+ * This is part of the DUNE DAQ Software Suite, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#include "FaultInjector.hpp"
+
+#include "listrev/dal/FaultInjectionConfig.hpp"
+
+#include "CommonIssues.hpp"
+
+#include <sstream>
+#include <thread>
+
+namespace {
+int64_t
+steady_now_ns()
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+    .count();
+}
+} // namespace
+
+void
+dunedaq::listrev::FaultInjector::configure(const dal::FaultInjectionConfig* config, const std::string& stream)
+{
+  Settings settings;
+  if (config != nullptr) {
+    settings.delay = std::chrono::microseconds(config->get_delay_us());
+    settings.random_delay = std::chrono::microseconds(config->get_random_delay_us());
+    settings.drop_probability = config->get_drop_probability();
+    settings.corrupt_probability = config->get_corrupt_probability();
+    settings.stall_probability = config->get_stall_probability();
+    settings.stall = std::chrono::milliseconds(config->get_stall_ms());
+    settings.seed = config->get_seed();
+  }
+  configure(settings, stream);
+}
+
+void
+dunedaq::listrev::FaultInjector::configure(const Settings& settings, const std::string& stream)
+{
+  for (auto probability : { settings.drop_probability, settings.corrupt_probability, settings.stall_probability }) {
+    if (!(probability >= 0 && probability <= 1)) {
+      throw FaultInjectionError(ERS_HERE, "probability " + std::to_string(probability) + " is outside [0, 1]");
+    }
+  }
+  m_settings = settings;
+  update_active();
+
+  // FNV-1a, so that the seed of a stream does not depend on the standard library
+  uint64_t hash = 14695981039346656037ULL; // NOLINT(build/unsigned)
+  for (char c : stream) {
+    hash = (hash ^ static_cast<unsigned char>(c)) * 1099511628211ULL;
+  }
+  std::lock_guard<std::mutex> lk(m_rng_mutex);
+  m_rng.seed(hash ^ settings.seed);
+  m_stall_until_ns = 0;
+}
+
+void
+dunedaq::listrev::FaultInjector::update_active()
+{
+  m_active = m_settings.delay.count() > 0 || m_settings.random_delay.count() > 0 || m_settings.drop_probability > 0 ||
+             m_settings.corrupt_probability > 0 || (m_settings.stall_probability > 0 && m_settings.stall.count() > 0);
+}
+
+bool
+dunedaq::listrev::FaultInjector::disable_corruption()
+{
+  bool configured = m_settings.corrupt_probability > 0;
+  m_settings.corrupt_probability = 0;
+  update_active();
+  return configured;
+}
+
+std::string
+dunedaq::listrev::FaultInjector::describe() const
+{
+  std::ostringstream out;
+  out << "delay " << m_settings.delay.count() << " us + up to " << m_settings.random_delay.count() << " us, drop "
+      << m_settings.drop_probability << ", corrupt " << m_settings.corrupt_probability << ", stall "
+      << m_settings.stall.count() << " ms with probability " << m_settings.stall_probability << ", seed "
+      << m_settings.seed;
+  return out.str();
+}
+
+double
+dunedaq::listrev::FaultInjector::uniform()
+{
+  std::lock_guard<std::mutex> lk(m_rng_mutex);
+  return std::uniform_real_distribution<double>(0, 1)(m_rng);
+}
+
+size_t
+dunedaq::listrev::FaultInjector::uniform_index(size_t size)
+{
+  std::lock_guard<std::mutex> lk(m_rng_mutex);
+  return std::uniform_int_distribution<size_t>(0, size - 1)(m_rng);
+}
+
+bool
+dunedaq::listrev::FaultInjector::pass()
+{
+  if (!m_active) {
+    return true;
+  }
+  ++m_messages;
+
+  // A stall holds every message that arrives before it ends, as a frozen component would
+  auto now_ns = steady_now_ns();
+  auto stall_until = m_stall_until_ns.load(std::memory_order_acquire);
+  if (stall_until <= now_ns && m_settings.stall_probability > 0 && m_settings.stall.count() > 0 &&
+      uniform() < m_settings.stall_probability) {
+    auto until = now_ns + std::chrono::duration_cast<std::chrono::nanoseconds>(m_settings.stall).count();
+    if (m_stall_until_ns.compare_exchange_strong(stall_until, until, std::memory_order_acq_rel)) {
+      ++m_stalls;
+      stall_until = until;
+    }
+  }
+  if (stall_until > now_ns) {
+    ++m_stalled;
+    m_stall_us += (stall_until - now_ns) / 1000;
+    std::this_thread::sleep_for(std::chrono::nanoseconds(stall_until - now_ns));
+  }
+
+  auto delay = m_settings.delay;
+  if (m_settings.random_delay.count() > 0) {
+    delay += std::chrono::microseconds(static_cast<int64_t>(uniform() * m_settings.random_delay.count()));
+  }
+  if (delay.count() > 0) {
+    m_delay_us += delay.count();
+    std::this_thread::sleep_for(delay);
+  }
+
+  if (m_settings.drop_probability > 0 && uniform() < m_settings.drop_probability) {
+    ++m_dropped;
+    return false;
+  }
+  return true;
+}
+
+bool
+dunedaq::listrev::FaultInjector::corrupts()
+{
+  return m_active && m_settings.corrupt_probability > 0 && uniform() < m_settings.corrupt_probability;
+}
+
+dunedaq::listrev::opmon::FaultInjectionInfo
+dunedaq::listrev::FaultInjector::generate_opmon_data()
+{
+  auto messages = m_messages.snapshot();
+  auto delay_us = m_delay_us.snapshot();
+  auto stalls = m_stalls.snapshot();
+  auto stalled = m_stalled.snapshot();
+  auto stall_us = m_stall_us.snapshot();
+  auto dropped = m_dropped.snapshot();
+  auto corrupted = m_corrupted.snapshot();
+
+  opmon::FaultInjectionInfo info;
+  info.set_messages(messages.delta);
+  info.set_total_messages(messages.total);
+  info.set_delay_us(delay_us.delta);
+  info.set_total_delay_us(delay_us.total);
+  info.set_stalls(stalls.delta);
+  info.set_total_stalls(stalls.total);
+  info.set_stalled_messages(stalled.delta);
+  info.set_total_stalled_messages(stalled.total);
+  info.set_stall_us(stall_us.delta);
+  info.set_total_stall_us(stall_us.total);
+  info.set_dropped_messages(dropped.delta);
+  info.set_total_dropped_messages(dropped.total);
+  info.set_corrupted_messages(corrupted.delta);
+  info.set_total_corrupted_messages(corrupted.total);
+  return info;
+}
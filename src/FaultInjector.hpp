@@ -0,0 +1,127 @@
+/**
+ * @file FaultInjector.hpp
+ *
+ * FaultInjector makes a module slow or lossy on purpose, to measure how throughput, tail latency and the timeout
+ * handling of the other modules respond. At its injection point a module calls pass() for every message: the
+ * calling thread is held for the configured fixed and random delays, and for the rest of any stall episode in
+ * progress, and the message may be dropped. corrupts() then decides whether the module alters the message's
+ * payload with corrupt().
+ *
+ * All random choices come from one generator seeded from the configuration and the module name, so a run with the
+ * same configuration and message order injects the same faults.
+ *
+ * This is part of the DUNE DAQ Software Suite, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#ifndef LISTREV_PLUGINS_FAULTINJECTOR_HPP_
+#define LISTREV_PLUGINS_FAULTINJECTOR_HPP_
+
+#include "ShardedCounter.hpp"
+
+#include "listrev/opmon/list_rev_info.pb.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace dunedaq {
+namespace listrev {
+namespace dal {
+class FaultInjectionConfig;
+} // namespace dal
+
+class FaultInjector
+{
+public:
+  struct Settings
+  {
+    std::chrono::microseconds delay{ 0 };        ///< Added to every message
+    std::chrono::microseconds random_delay{ 0 }; ///< Upper bound of a uniformly distributed extra delay
+    double drop_probability{ 0 };
+    double corrupt_probability{ 0 };
+    double stall_probability{ 0 };               ///< Per message, of starting a stall episode
+    std::chrono::milliseconds stall{ 0 };        ///< Length of a stall episode
+    uint32_t seed{ 1 };                          // NOLINT(build/unsigned)
+  };
+
+  FaultInjector() = default;
+  FaultInjector(const FaultInjector&) = delete;
+  FaultInjector& operator=(const FaultInjector&) = delete;
+
+  /**
+   * @brief Configure from the module's fault_injection relationship; a null config disables injection
+   * @param stream Mixed into the seed, so that modules sharing a configuration see different faults
+   * @throws FaultInjectionError for a probability outside [0, 1]
+   */
+  void configure(const dal::FaultInjectionConfig* config, const std::string& stream);
+  void configure(const Settings& settings, const std::string& stream);
+
+  bool active() const { return m_active; }
+
+  /**
+   * @brief Turn off corruption, for an injection point where a corrupted message could not be detected downstream
+   * @return whether corruption was configured
+   */
+  bool disable_corruption();
+  std::string describe() const;
+
+  /**
+   * @brief Apply the delays and stalls to the calling thread
+   * @return false if the message is to be dropped
+   */
+  bool pass();
+
+  /**
+   * @brief Whether the current message is to be corrupted
+   */
+  bool corrupts();
+
+  /**
+   * @brief Flip the lowest bit of one element of data, chosen at random; nothing if data is empty
+   */
+  template<typename T>
+  void corrupt(std::vector<T>& data)
+  {
+    if (data.empty()) {
+      return;
+    }
+    data[uniform_index(data.size())] ^= 1;
+    ++m_corrupted;
+  }
+
+  /**
+   * @brief Fill an opmon message with the faults injected since the previous call, and in total
+   */
+  opmon::FaultInjectionInfo generate_opmon_data();
+
+private:
+  void update_active();
+  double uniform();
+  size_t uniform_index(size_t size);
+
+  Settings m_settings;
+  bool m_active{ false };
+
+  std::mutex m_rng_mutex;
+  std::mt19937_64 m_rng;
+  std::atomic<int64_t> m_stall_until_ns{ 0 }; ///< steady_clock time at which the current stall episode ends
+
+  ShardedCounter m_messages;
+  ShardedCounter m_delay_us;
+  ShardedCounter m_stalls;
+  ShardedCounter m_stalled;
+  ShardedCounter m_stall_us;
+  ShardedCounter m_dropped;
+  ShardedCounter m_corrupted;
+};
+
+} // namespace listrev
+} // namespace dunedaq
+
+#endif // LISTREV_PLUGINS_FAULTINJECTOR_HPP_
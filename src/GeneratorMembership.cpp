@@ -0,0 +1,101 @@
+/**
+ * @file GeneratorMembership.cpp GeneratorMembership implementation
+ *
+ * This is part of the DUNE DAQ Software Suite, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#include "GeneratorMembership.hpp"
+
+#include <algorithm>
+
+void
+dunedaq::listrev::GeneratorMembership::reset(const std::vector<std::string>& connections,
+                                             std::chrono::milliseconds timeout)
+{
+  std::lock_guard<std::mutex> lk(m_mutex);
+  m_connections = connections;
+  m_timeout = timeout;
+  m_members.clear();
+}
+
+bool
+dunedaq::listrev::GeneratorMembership::join(int generator_id,
+                                            const std::string& connection,
+                                            std::chrono::steady_clock::time_point now)
+{
+  std::lock_guard<std::mutex> lk(m_mutex);
+  auto [it, created] = m_members.emplace(generator_id, Member{ generator_id, connection, now, now });
+  it->second.last_seen = now;
+  return created;
+}
+
+dunedaq::listrev::GeneratorMembership::Change
+dunedaq::listrev::GeneratorMembership::update(const GeneratorHeartbeat& heartbeat,
+                                              std::chrono::steady_clock::time_point now,
+                                              Member& member)
+{
+  std::lock_guard<std::mutex> lk(m_mutex);
+  auto it = m_members.find(heartbeat.generator_id);
+  if (heartbeat.withdraw) {
+    if (it == m_members.end()) {
+      return Change::None;
+    }
+    member = it->second;
+    m_members.erase(it);
+    return Change::Left;
+  }
+  if (it != m_members.end()) {
+    it->second.last_seen = now;
+    member = it->second;
+    return Change::None;
+  }
+
+  // A generator serving several reversers lists all its request inputs; only one of them is ours
+  for (auto& conn : heartbeat.request_connections) {
+    if (std::find(m_connections.begin(), m_connections.end(), conn) != m_connections.end()) {
+      member = Member{ heartbeat.generator_id, conn, now, now };
+      m_members.emplace(heartbeat.generator_id, member);
+      return Change::Joined;
+    }
+  }
+  return Change::None;
+}
+
+std::vector<dunedaq::listrev::GeneratorMembership::Member>
+dunedaq::listrev::GeneratorMembership::expire(std::chrono::steady_clock::time_point now)
+{
+  std::lock_guard<std::mutex> lk(m_mutex);
+  std::vector<Member> expired;
+  if (m_timeout.count() == 0) {
+    return expired;
+  }
+  for (auto it = m_members.begin(); it != m_members.end();) {
+    if (now - it->second.last_seen > m_timeout) {
+      expired.push_back(it->second);
+      it = m_members.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  return expired;
+}
+
+std::vector<dunedaq::listrev::GeneratorMembership::Member>
+dunedaq::listrev::GeneratorMembership::members() const
+{
+  std::lock_guard<std::mutex> lk(m_mutex);
+  std::vector<Member> members;
+  for (auto& [id, member] : m_members) {
+    members.push_back(member);
+  }
+  return members;
+}
+
+size_t
+dunedaq::listrev::GeneratorMembership::size() const
+{
+  std::lock_guard<std::mutex> lk(m_mutex);
+  return m_members.size();
+}
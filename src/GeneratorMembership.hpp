@@ -0,0 +1,86 @@
+/**
+ * @file GeneratorMembership.hpp
+ *
+ * GeneratorMembership is a ListReverser's view of which generators are running. Generators announce themselves
+ * with a GeneratorHeartbeat at a regular interval and withdraw with a final one; a generator is a member while its
+ * heartbeats name one of the reverser's RequestList outputs, and stops being one when it withdraws or falls silent
+ * for longer than the timeout. The reverser fans its requests out to the members and waits for one list from each.
+ *
+ * All methods may be called concurrently.
+ *
+ * This is part of the DUNE DAQ Software Suite, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#ifndef LISTREV_PLUGINS_GENERATORMEMBERSHIP_HPP_
+#define LISTREV_PLUGINS_GENERATORMEMBERSHIP_HPP_
+
+#include "ListWrapper.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace dunedaq {
+namespace listrev {
+
+class GeneratorMembership
+{
+public:
+  struct Member
+  {
+    int generator_id{ 0 };
+    std::string connection; ///< The reverser's RequestList output that reaches the generator
+    std::chrono::steady_clock::time_point joined;
+    std::chrono::steady_clock::time_point last_seen;
+  };
+
+  enum class Change
+  {
+    None,   ///< A heartbeat from a member, or one that names none of the connections
+    Joined, ///< The generator was not a member before
+    Left,   ///< The generator withdrew
+  };
+
+  /**
+   * @brief Forget all members. Heartbeats are accepted only if they name one of connections, and a member is
+   * dropped once it has sent none for timeout; with a zero timeout, only when it withdraws.
+   */
+  void reset(const std::vector<std::string>& connections, std::chrono::milliseconds timeout);
+
+  /**
+   * @brief Make a generator a member as if it had just sent a heartbeat through connection
+   * @return Whether it was not a member before
+   */
+  bool join(int generator_id, const std::string& connection, std::chrono::steady_clock::time_point now);
+
+  /**
+   * @brief Apply a heartbeat
+   * @param member Set to the generator's membership, as it was before it left for Change::Left
+   */
+  Change update(const GeneratorHeartbeat& heartbeat, std::chrono::steady_clock::time_point now, Member& member);
+
+  /**
+   * @brief Drop the members that have been silent for longer than the timeout
+   * @return The dropped members
+   */
+  std::vector<Member> expire(std::chrono::steady_clock::time_point now);
+
+  std::vector<Member> members() const;
+  size_t size() const;
+
+private:
+  std::vector<std::string> m_connections;
+  std::chrono::milliseconds m_timeout{ 0 };
+  std::map<int, Member> m_members;
+  mutable std::mutex m_mutex;
+};
+
+} // namespace listrev
+} // namespace dunedaq
+
+#endif // LISTREV_PLUGINS_GENERATORMEMBERSHIP_HPP_
@@ -0,0 +1,130 @@
+/**
+ * @file LatencyHistogram.cpp LatencyHistogram implementations
+ *
+ * This is part of the DUNE DAQ Software Suite, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#include "LatencyHistogram.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+size_t
+dunedaq::listrev::LatencyHistogram::bucket_index(uint64_t value) // NOLINT(build/unsigned)
+{
+  if (value < s_sub_buckets) {
+    return value;
+  }
+  unsigned msb = 63 - __builtin_clzll(value);
+  unsigned shift = msb - s_sub_bucket_bits;
+  return (msb - s_sub_bucket_bits + 1) * s_sub_buckets + ((value >> shift) & (s_sub_buckets - 1));
+}
+
+uint64_t // NOLINT(build/unsigned)
+dunedaq::listrev::LatencyHistogram::bucket_upper_edge(size_t index)
+{
+  if (index < s_sub_buckets) {
+    return index;
+  }
+  unsigned msb = index / s_sub_buckets + s_sub_bucket_bits - 1;
+  unsigned shift = msb - s_sub_bucket_bits;
+  uint64_t lower = (s_sub_buckets + index % s_sub_buckets) << shift; // NOLINT(build/unsigned)
+  return lower + ((uint64_t(1) << shift) - 1);                        // NOLINT(build/unsigned)
+}
+
+void
+dunedaq::listrev::LatencyHistogram::record(std::chrono::nanoseconds latency)
+{
+  uint64_t value = latency.count() > 0 ? latency.count() : 0; // NOLINT(build/unsigned)
+  auto& shard = m_shards[ShardedCounter::shard_index() % s_num_shards];
+  shard.buckets[bucket_index(value)].fetch_add(1, std::memory_order_relaxed);
+  shard.count.fetch_add(1, std::memory_order_relaxed);
+  shard.sum_ns.fetch_add(value, std::memory_order_relaxed);
+
+  auto current = shard.max_ns.load(std::memory_order_relaxed);
+  while (value > current && !shard.max_ns.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+  }
+}
+
+uint64_t // NOLINT(build/unsigned)
+dunedaq::listrev::LatencyHistogram::count() const
+{
+  uint64_t count = 0; // NOLINT(build/unsigned)
+  for (auto& shard : m_shards) {
+    count += shard.count.load(std::memory_order_relaxed);
+  }
+  return count;
+}
+
+uint64_t // NOLINT(build/unsigned)
+dunedaq::listrev::LatencyHistogram::max_ns() const
+{
+  uint64_t max = 0; // NOLINT(build/unsigned)
+  for (auto& shard : m_shards) {
+    max = std::max(max, shard.max_ns.load(std::memory_order_relaxed));
+  }
+  return max;
+}
+
+uint64_t // NOLINT(build/unsigned)
+dunedaq::listrev::LatencyHistogram::bucket_count(size_t index) const
+{
+  uint64_t count = 0; // NOLINT(build/unsigned)
+  for (auto& shard : m_shards) {
+    count += shard.buckets[index].load(std::memory_order_relaxed);
+  }
+  return count;
+}
+
+double
+dunedaq::listrev::LatencyHistogram::mean_ns() const
+{
+  uint64_t count = 0; // NOLINT(build/unsigned)
+  uint64_t sum = 0;   // NOLINT(build/unsigned)
+  for (auto& shard : m_shards) {
+    count += shard.count.load(std::memory_order_relaxed);
+    sum += shard.sum_ns.load(std::memory_order_relaxed);
+  }
+  return count > 0 ? static_cast<double>(sum) / count : 0.;
+}
+
+uint64_t // NOLINT(build/unsigned)
+dunedaq::listrev::LatencyHistogram::percentile_ns(double percentile) const
+{
+  std::array<uint64_t, s_num_buckets> buckets; // NOLINT(build/unsigned)
+  uint64_t total = 0;                          // NOLINT(build/unsigned)
+  for (size_t idx = 0; idx < s_num_buckets; ++idx) {
+    buckets[idx] = bucket_count(idx);
+    total += buckets[idx];
+  }
+  if (total == 0) {
+    return 0;
+  }
+
+  auto max = max_ns();
+  auto rank = static_cast<uint64_t>(std::ceil(std::clamp(percentile, 0., 100.) / 100. * total)); // NOLINT
+  rank = std::max<uint64_t>(rank, 1);                                                            // NOLINT
+  uint64_t seen = 0;                                                                             // NOLINT
+  for (size_t idx = 0; idx < s_num_buckets; ++idx) {
+    seen += buckets[idx];
+    if (seen >= rank) {
+      return std::min(bucket_upper_edge(idx), max);
+    }
+  }
+  return max;
+}
+
+void
+dunedaq::listrev::LatencyHistogram::reset()
+{
+  for (auto& shard : m_shards) {
+    for (auto& bucket : shard.buckets) {
+      bucket.store(0, std::memory_order_relaxed);
+    }
+    shard.count.store(0, std::memory_order_relaxed);
+    shard.sum_ns.store(0, std::memory_order_relaxed);
+    shard.max_ns.store(0, std::memory_order_relaxed);
+  }
+}
@@ -0,0 +1,78 @@
+/**
+ * @file LatencyHistogram.hpp
+ *
+ * LatencyHistogram records durations in log-linear buckets (16 linear
+ * sub-buckets per power of two, so percentiles are accurate to about 6%)
+ * with constant memory and lock-free, allocation-free recording. Threads
+ * record into one of a few shards, assigned as for ShardedCounter, so that
+ * callbacks on different threads do not contend on the counts.
+ *
+ * This is part of the DUNE DAQ Software Suite, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#ifndef LISTREV_PLUGINS_LATENCYHISTOGRAM_HPP_
+#define LISTREV_PLUGINS_LATENCYHISTOGRAM_HPP_
+
+#include "ShardedCounter.hpp"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace dunedaq {
+namespace listrev {
+
+class LatencyHistogram
+{
+public:
+  LatencyHistogram() = default;
+  LatencyHistogram(const LatencyHistogram&) = delete;
+  LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+  /**
+   * @brief Record one duration. May be called concurrently from any number of threads.
+   */
+  void record(std::chrono::nanoseconds latency);
+
+  uint64_t count() const; // NOLINT(build/unsigned)
+  uint64_t max_ns() const; // NOLINT(build/unsigned)
+  double mean_ns() const;
+
+  /**
+   * @brief Upper edge of the bucket holding the given percentile (0-100) of the recorded values, or 0 if empty
+   */
+  uint64_t percentile_ns(double percentile) const; // NOLINT(build/unsigned)
+
+  /**
+   * @brief Forget all recorded values. Not safe against concurrent record() calls.
+   */
+  void reset();
+
+private:
+  static constexpr unsigned s_sub_bucket_bits = 4;
+  static constexpr size_t s_sub_buckets = size_t(1) << s_sub_bucket_bits;
+  static constexpr size_t s_num_buckets = 64 * s_sub_buckets;
+  static constexpr size_t s_num_shards = 8;
+
+  static size_t bucket_index(uint64_t value);      // NOLINT(build/unsigned)
+  static uint64_t bucket_upper_edge(size_t index); // NOLINT(build/unsigned)
+
+  uint64_t bucket_count(size_t index) const; // NOLINT(build/unsigned)
+
+  struct alignas(ShardedCounter::s_cache_line_size) Shard
+  {
+    std::atomic<uint64_t> count{ 0 };                            // NOLINT(build/unsigned)
+    std::atomic<uint64_t> sum_ns{ 0 };                           // NOLINT(build/unsigned)
+    std::atomic<uint64_t> max_ns{ 0 };                           // NOLINT(build/unsigned)
+    std::array<std::atomic<uint64_t>, s_num_buckets> buckets{}; // NOLINT(build/unsigned)
+  };
+  std::array<Shard, s_num_shards> m_shards;
+};
+
+} // namespace listrev
+} // namespace dunedaq
+
+#endif // LISTREV_PLUGINS_LATENCYHISTOGRAM_HPP_
@@ -9,35 +9,50 @@
  */
 
 #include "ListCreator.hpp"
-
-#include "iomanager/IOManager.hpp"
-#include "iomanager/Sender.hpp"
+#include "ListTrace.hpp"
 
 dunedaq::listrev::ListCreator::ListCreator(std::string conn,
-                                                  std::chrono::milliseconds tmo,
-                                                  int min_list_size,
-                                                  int max_list_size)
-  : m_create_connection(conn)
+                                           std::chrono::milliseconds tmo,
+                                           int min_list_size,
+                                           int max_list_size,
+                                           uint32_t size_seed) // NOLINT(build/unsigned)
+  : m_sizes(size_seed, min_list_size, max_list_size)
+  , m_create_connection(conn)
   , m_send_timeout(tmo)
 {
-  std::random_device seed;
-  m_random_generator = std::mt19937(seed());
+}
 
-  if (min_list_size < 0) {
-    min_list_size = 1;
-  }
-  if (max_list_size < min_list_size) {
-    max_list_size = min_list_size;
-  }
-  m_size_dist = std::uniform_int_distribution<>{ min_list_size, max_list_size };
+void
+dunedaq::listrev::ListCreator::start()
+{
+  m_sizes.reset();
+  m_create_sender = m_senders.resolve(m_create_connection);
 }
 
 void
-dunedaq::listrev::ListCreator::send_create(int id)
+dunedaq::listrev::ListCreator::stop()
+{
+  m_create_sender = nullptr;
+  m_senders.clear();
+}
+
+void
+dunedaq::listrev::ListCreator::send_create(int id, int64_t deadline_ns, uint64_t trace_id) // NOLINT(build/unsigned)
 {
   CreateList req;
   req.list_id = id;
-  req.list_size = m_size_dist(m_random_generator);
+  req.list_size = m_sizes.next();
+  req.deadline_ns = deadline_ns;
+  if (trace_id != 0) {
+    req.trace_id = trace_id;
+    req.trace_ns = ListTracer::now_ns();
+  }
 
-  get_iomanager()->get_sender<CreateList>(m_create_connection)->send(std::move(req), m_send_timeout);
+  SenderCache<CreateList>::send(m_create_sender, std::move(req), m_send_timeout);
+}
+
+void
+dunedaq::listrev::ListCreator::skip_create(int /*id*/)
+{
+  m_sizes.next();
 }
@@ -11,9 +11,12 @@
 #ifndef LISTREV_PLUGINS_LISTCREATOR_HPP_
 #define LISTREV_PLUGINS_LISTCREATOR_HPP_
 
+#include "ListSizeSchedule.hpp"
 #include "ListWrapper.hpp"
+#include "SenderCache.hpp"
 
-#include <random>
+#include <cstdint>
+#include <string>
 
 namespace dunedaq {
 namespace listrev {
@@ -21,20 +24,37 @@ namespace listrev {
 class ListCreator
 {
 public:
-  ListCreator() = default;
-  ListCreator(std::string conn, std::chrono::milliseconds tmo, int min_list_size, int max_list_size);
+  ListCreator(std::string conn,
+              std::chrono::milliseconds tmo,
+              int min_list_size,
+              int max_list_size,
+              uint32_t size_seed = 0); // NOLINT(build/unsigned)
 
   // Methods
-  void send_create(int id);
+  /**
+   * @brief Resolve the sender and restart the list size sequence
+   */
+  void start();
+  void stop();
+  void send_create(int id, int64_t deadline_ns = 0, uint64_t trace_id = 0); // NOLINT(build/unsigned)
+  /**
+   * @brief Consume the size of list id without sending a CreateList, for a list the generators pre-generated
+   */
+  void skip_create(int id);
+
+  SenderCache<CreateList>& senders() { return m_senders; }
 
 private:
   // Data
-  std::mt19937 m_random_generator;
-  std::uniform_int_distribution<> m_size_dist;
+  ListSizeSchedule m_sizes;
 
   // Configuration
   std::string m_create_connection;
   std::chrono::milliseconds m_send_timeout;
+
+  // Senders
+  SenderCache<CreateList> m_senders;
+  SenderCache<CreateList>::Entry* m_create_sender{ nullptr };
 };
 } // namespace listrev
 } // namespace dunedaq
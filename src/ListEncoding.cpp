@@ -0,0 +1,384 @@
+/**
+ * @file ListEncoding.cpp List encoding implementations
+ *
+ * Stride detection and bit-unpacking are written without data-dependent branches (the stride check accumulates a
+ * flag instead of returning early, unpacking reads a fixed 8-byte window per element) so that the compiler can
+ * vectorise them. Varint coding and bit-packing branch on each value's size and stay scalar.
+ *
+ * This is part of the DUNE DAQ Software Suite, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#include "ListEncoding.hpp"
+
+#include "CommonIssues.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+namespace dunedaq {
+namespace listrev {
+namespace {
+
+/// Upper bound on the element count accepted from an encoded message
+constexpr uint64_t s_max_elements = 1 << 26; // NOLINT(build/unsigned)
+/// Bit-packed data is followed by this many zero bytes, so that unpacking can always read a full 64-bit word
+constexpr size_t s_pack_padding = 8;
+
+inline uint64_t // NOLINT(build/unsigned)
+zigzag(int64_t value)
+{
+  return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63); // NOLINT(build/unsigned)
+}
+inline int64_t
+unzigzag(uint64_t value) // NOLINT(build/unsigned)
+{
+  return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+inline size_t
+varint_size(uint64_t value) // NOLINT(build/unsigned)
+{
+  size_t size = 1;
+  while (value >= 0x80) {
+    value >>= 7;
+    ++size;
+  }
+  return size;
+}
+inline void
+put_varint(uint64_t value, std::vector<uint8_t>& out) // NOLINT(build/unsigned)
+{
+  while (value >= 0x80) {
+    out.push_back(static_cast<uint8_t>(value | 0x80)); // NOLINT(build/unsigned)
+    value >>= 7;
+  }
+  out.push_back(static_cast<uint8_t>(value)); // NOLINT(build/unsigned)
+}
+
+class Reader
+{
+public:
+  Reader(const uint8_t* data, size_t size) // NOLINT(build/unsigned)
+    : m_pos(data)
+    , m_end(data + size)
+  {
+  }
+
+  uint64_t varint() // NOLINT(build/unsigned)
+  {
+    uint64_t value = 0; // NOLINT(build/unsigned)
+    for (unsigned shift = 0; shift < 64; shift += 7) {
+      if (m_pos == m_end) {
+        throw ListEncodingError(ERS_HERE, "truncated varint");
+      }
+      uint8_t byte = *m_pos++;                  // NOLINT(build/unsigned)
+      value |= static_cast<uint64_t>(byte & 0x7f) << shift; // NOLINT(build/unsigned)
+      if ((byte & 0x80) == 0) {
+        return value;
+      }
+    }
+    throw ListEncodingError(ERS_HERE, "varint longer than 64 bits");
+  }
+  uint8_t byte() // NOLINT(build/unsigned)
+  {
+    if (m_pos == m_end) {
+      throw ListEncodingError(ERS_HERE, "truncated header");
+    }
+    return *m_pos++;
+  }
+  const uint8_t* position() const { return m_pos; } // NOLINT(build/unsigned)
+  size_t remaining() const { return m_end - m_pos; }
+
+private:
+  const uint8_t* m_pos; // NOLINT(build/unsigned)
+  const uint8_t* m_end; // NOLINT(build/unsigned)
+};
+
+/**
+ * @brief Whether values is an arithmetic sequence, and its common difference
+ */
+bool
+constant_stride(const std::vector<int>& values, int64_t& stride)
+{
+  stride = values.size() > 1 ? static_cast<int64_t>(values[1]) - values[0] : 0;
+  bool constant = true;
+  for (size_t idx = 1; idx < values.size(); ++idx) {
+    constant &= static_cast<int64_t>(values[idx]) - values[idx - 1] == stride;
+  }
+  return constant;
+}
+
+void
+encode_stride(const std::vector<int>& values, int64_t stride, std::vector<uint8_t>& out) // NOLINT(build/unsigned)
+{
+  if (!values.empty()) {
+    put_varint(zigzag(values[0]), out);
+    put_varint(zigzag(stride), out);
+  }
+}
+
+void
+encode_delta(const std::vector<int>& values, std::vector<uint8_t>& out) // NOLINT(build/unsigned)
+{
+  int64_t previous = 0;
+  for (auto value : values) {
+    put_varint(zigzag(value - previous), out);
+    previous = value;
+  }
+}
+
+unsigned
+bit_width(uint64_t range) // NOLINT(build/unsigned)
+{
+  unsigned width = 0;
+  while (range != 0) {
+    range >>= 1;
+    ++width;
+  }
+  return width;
+}
+
+void
+encode_for(const std::vector<int>& values, int min, unsigned width, std::vector<uint8_t>& out) // NOLINT(build/unsigned)
+{
+  put_varint(zigzag(min), out);
+  out.push_back(static_cast<uint8_t>(width)); // NOLINT(build/unsigned)
+
+  auto start = out.size();
+  out.resize(start + (values.size() * width + 7) / 8 + s_pack_padding, 0);
+  if (width == 0) {
+    return;
+  }
+  uint8_t* packed = out.data() + start; // NOLINT(build/unsigned)
+  uint64_t accumulator = 0;             // NOLINT(build/unsigned)
+  unsigned bits = 0;
+  for (auto value : values) {
+    accumulator |= static_cast<uint64_t>(static_cast<uint32_t>(static_cast<int64_t>(value) - min)) << bits; // NOLINT(build/unsigned)
+    bits += width;
+    while (bits >= 8) {
+      *packed++ = static_cast<uint8_t>(accumulator); // NOLINT(build/unsigned)
+      accumulator >>= 8;
+      bits -= 8;
+    }
+  }
+  if (bits > 0) {
+    *packed = static_cast<uint8_t>(accumulator); // NOLINT(build/unsigned)
+  }
+}
+
+} // namespace
+} // namespace listrev
+} // namespace dunedaq
+
+dunedaq::listrev::ListEncoding
+dunedaq::listrev::parse_list_encoding(const std::string& name)
+{
+  for (auto encoding : { ListEncoding::None,
+                         ListEncoding::Stride,
+                         ListEncoding::DeltaVarint,
+                         ListEncoding::FrameOfReference,
+                         ListEncoding::Auto }) {
+    if (name == list_encoding_name(encoding)) {
+      return encoding;
+    }
+  }
+  if (name.empty()) {
+    return ListEncoding::None;
+  }
+  throw ListEncodingError(ERS_HERE, "unknown encoding \"" + name + "\"");
+}
+
+const char*
+dunedaq::listrev::list_encoding_name(ListEncoding encoding)
+{
+  switch (encoding) {
+    case ListEncoding::None:
+      return "none";
+    case ListEncoding::Stride:
+      return "stride";
+    case ListEncoding::DeltaVarint:
+      return "delta";
+    case ListEncoding::FrameOfReference:
+      return "for";
+    case ListEncoding::Auto:
+      return "auto";
+  }
+  return "unknown";
+}
+
+dunedaq::listrev::ListEncoding
+dunedaq::listrev::encode_values(const std::vector<int>& values, ListEncoding encoding, std::vector<uint8_t>& out) // NOLINT(build/unsigned)
+{
+  out.clear();
+  put_varint(values.size(), out);
+
+  int64_t stride = 0;
+  if (encoding == ListEncoding::Stride || encoding == ListEncoding::Auto) {
+    if (constant_stride(values, stride)) {
+      encode_stride(values, stride, out);
+      return ListEncoding::Stride;
+    }
+    if (encoding == ListEncoding::Stride) {
+      encoding = ListEncoding::DeltaVarint;
+    }
+  }
+
+  int min = 0;
+  unsigned width = 0;
+  if (encoding == ListEncoding::FrameOfReference || encoding == ListEncoding::Auto) {
+    auto [min_it, max_it] = std::minmax_element(values.begin(), values.end());
+    if (min_it != values.end()) {
+      min = *min_it;
+      width = bit_width(static_cast<uint64_t>(static_cast<int64_t>(*max_it) - min)); // NOLINT(build/unsigned)
+    }
+  }
+
+  if (encoding == ListEncoding::Auto) {
+    size_t for_size = (values.size() * width + 7) / 8 + s_pack_padding + 6;
+    size_t delta_size = 0;
+    int64_t previous = 0;
+    for (auto value : values) {
+      delta_size += varint_size(zigzag(value - previous));
+      previous = value;
+    }
+    encoding = delta_size < for_size ? ListEncoding::DeltaVarint : ListEncoding::FrameOfReference;
+  }
+
+  if (encoding == ListEncoding::FrameOfReference) {
+    encode_for(values, min, width, out);
+  } else {
+    encode_delta(values, out);
+  }
+  return encoding;
+}
+
+void
+dunedaq::listrev::decode_values(const uint8_t* data, size_t size, ListEncoding encoding, std::vector<int>& values) // NOLINT(build/unsigned)
+{
+  Reader reader(data, size);
+  auto count = reader.varint();
+  if (count > s_max_elements) {
+    throw ListEncodingError(ERS_HERE, "element count " + std::to_string(count) + " out of range");
+  }
+  if (count == 0) {
+    values.clear();
+    return;
+  }
+
+  // Each case checks that the message can hold count elements before values is sized for them
+  switch (encoding) {
+    case ListEncoding::Stride: {
+      auto first = unzigzag(reader.varint());
+      auto stride = count > 1 ? unzigzag(reader.varint()) : 0;
+      values.resize(count);
+      for (size_t idx = 0; idx < count; ++idx) {
+        values[idx] = static_cast<int>(first + static_cast<int64_t>(idx) * stride);
+      }
+      break;
+    }
+    case ListEncoding::DeltaVarint: {
+      if (reader.remaining() < count) {
+        throw ListEncodingError(ERS_HERE, "varint data truncated");
+      }
+      values.resize(count);
+      int64_t previous = 0;
+      for (size_t idx = 0; idx < count; ++idx) {
+        previous += unzigzag(reader.varint());
+        values[idx] = static_cast<int>(previous);
+      }
+      break;
+    }
+    case ListEncoding::FrameOfReference: {
+      auto min = unzigzag(reader.varint());
+      unsigned width = reader.byte();
+      if (width > 32 || reader.remaining() < (count * width + 7) / 8 + s_pack_padding) {
+        throw ListEncodingError(ERS_HERE, "bit-packed data truncated or too wide");
+      }
+      values.resize(count);
+      const uint8_t* packed = reader.position(); // NOLINT(build/unsigned)
+      uint64_t mask = (uint64_t(1) << width) - 1; // NOLINT(build/unsigned)
+      for (size_t idx = 0; idx < count; ++idx) {
+        size_t bit = idx * width;
+        uint64_t word; // NOLINT(build/unsigned)
+        std::memcpy(&word, packed + bit / 8, sizeof(word));
+        values[idx] = static_cast<int>(min + static_cast<int64_t>((word >> (bit % 8)) & mask));
+      }
+      break;
+    }
+    default:
+      throw ListEncodingError(ERS_HERE, "unknown encoding " + std::to_string(static_cast<int>(encoding)));
+  }
+}
+
+void
+dunedaq::listrev::encode(IntList& list, ListEncoding encoding)
+{
+  if (encoding == ListEncoding::None || list.encoding != 0) {
+    return;
+  }
+  list.encoding = static_cast<uint8_t>(encode_values(list.list, encoding, list.encoded)); // NOLINT(build/unsigned)
+  list.list.clear();
+}
+
+void
+dunedaq::listrev::encode(ReversedList& list, ListEncoding encoding)
+{
+  for (auto& data : list.lists) {
+    encode(data.original, encoding);
+    encode(data.reversed, encoding);
+  }
+}
+
+void
+dunedaq::listrev::decode(IntList& list)
+{
+  if (list.encoding == 0) {
+    return;
+  }
+  decode_values(list.encoded.data(), list.encoded.size(), static_cast<ListEncoding>(list.encoding), list.list);
+  list.encoded.clear();
+  list.encoding = 0;
+}
+
+void
+dunedaq::listrev::decode(ReversedList& list)
+{
+  for (auto& data : list.lists) {
+    decode(data.original);
+    decode(data.reversed);
+  }
+}
+
+const dunedaq::listrev::IntList&
+dunedaq::listrev::decoded(const IntList& list, IntList& scratch)
+{
+  if (list.encoding == 0) {
+    return list;
+  }
+  scratch.list_id = list.list_id;
+  scratch.generator_id = list.generator_id;
+  scratch.trace_id = list.trace_id;
+  scratch.trace_ns = list.trace_ns;
+  scratch.encoding = 0;
+  scratch.encoded.clear();
+  decode_values(list.encoded.data(), list.encoded.size(), static_cast<ListEncoding>(list.encoding), scratch.list);
+  return scratch;
+}
+
+const dunedaq::listrev::ReversedList&
+dunedaq::listrev::decoded(const ReversedList& list, ReversedList& scratch)
+{
+  bool encoded = false;
+  for (auto& data : list.lists) {
+    encoded |= data.original.encoding != 0 || data.reversed.encoding != 0;
+  }
+  if (!encoded) {
+    return list;
+  }
+  scratch = list;
+  decode(scratch);
+  return scratch;
+}
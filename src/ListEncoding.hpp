@@ -0,0 +1,94 @@
+/**
+ * @file ListEncoding.hpp
+ *
+ * Compact encodings of IntList contents for the wire. Generated lists are either arithmetic sequences
+ * (ListMode::Ascending, Descending, Evens, Odds) or small bounded values (ListMode::Random), so most of the four
+ * bytes per element that the plain encoding carries are redundant.
+ *
+ *  - Stride: the first value and the constant difference; any arithmetic sequence is a few bytes
+ *  - DeltaVarint: the first value, then each difference, zigzag-mapped and LEB128-encoded
+ *  - FrameOfReference: the minimum, then every value minus the minimum, bit-packed at the smallest width
+ *  - Auto: Stride when the list is an arithmetic sequence, otherwise the smaller of the other two
+ *
+ * An encoded IntList carries its elements in `encoded` and leaves `list` empty. Every encoding starts with the
+ * element count as a LEB128 varint.
+ *
+ * This is part of the DUNE DAQ Software Suite, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#ifndef LISTREV_PLUGINS_LISTENCODING_HPP_
+#define LISTREV_PLUGINS_LISTENCODING_HPP_
+
+#include "ListWrapper.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace dunedaq {
+namespace listrev {
+
+enum class ListEncoding : uint8_t // NOLINT(build/unsigned)
+{
+  None = 0,
+  Stride = 1,
+  DeltaVarint = 2,
+  FrameOfReference = 3,
+  Auto = 4, ///< Only valid as a request to encode(); never stored in a message
+};
+
+/**
+ * @brief Parse a list_encoding configuration value ("none", "stride", "delta", "for" or "auto")
+ * @throws ListEncodingError for an unknown name
+ */
+ListEncoding
+parse_list_encoding(const std::string& name);
+const char*
+list_encoding_name(ListEncoding encoding);
+
+/**
+ * @brief Encode values with the requested encoding, replacing the contents of out
+ * @return The encoding used; Auto resolves to one of the others, and Stride falls back to DeltaVarint for a list
+ * that is not an arithmetic sequence
+ */
+ListEncoding
+encode_values(const std::vector<int>& values, ListEncoding encoding, std::vector<uint8_t>& out); // NOLINT(build/unsigned)
+
+/**
+ * @brief Decode data, produced by encode_values with the given encoding, into values
+ * @throws ListEncodingError for truncated or malformed data
+ */
+void
+decode_values(const uint8_t* data, size_t size, ListEncoding encoding, std::vector<int>& values); // NOLINT(build/unsigned)
+
+/**
+ * @brief Move the elements of list into its encoded form. Does nothing for ListEncoding::None or an already
+ * encoded list.
+ */
+void
+encode(IntList& list, ListEncoding encoding);
+void
+encode(ReversedList& list, ListEncoding encoding);
+
+/**
+ * @brief Restore the elements of an encoded list in place
+ */
+void
+decode(IntList& list);
+void
+decode(ReversedList& list);
+
+/**
+ * @brief list itself if it is not encoded, otherwise scratch holding its decoded copy
+ */
+const IntList&
+decoded(const IntList& list, IntList& scratch);
+const ReversedList&
+decoded(const ReversedList& list, ReversedList& scratch);
+
+} // namespace listrev
+} // namespace dunedaq
+
+#endif // LISTREV_PLUGINS_LISTENCODING_HPP_
@@ -0,0 +1,374 @@
+/**
+ * @file ListFile.cpp ListFileWriter and ListFileReader implementations
+ *
+ * This is part of the DUNE DAQ Software Suite, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#include "ListFile.hpp"
+#include "CommonIssues.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+
+namespace {
+
+constexpr char s_file_magic[8] = { 'L', 'R', 'V', 'L', 'I', 'S', 'T', '\0' };
+constexpr char s_footer_magic[8] = { 'L', 'R', 'V', 'I', 'N', 'D', 'X', '\0' };
+
+size_t
+padded(size_t size)
+{
+  return (size + 7) & ~static_cast<size_t>(7);
+}
+
+size_t
+block_size(const dunedaq::listrev::IntList& list)
+{
+  return 3 * sizeof(int32_t) + list.list.size() * sizeof(int32_t);
+}
+
+char*
+write_block(char* out, const dunedaq::listrev::IntList& list)
+{
+  int32_t head[3] = { list.list_id, list.generator_id, static_cast<int32_t>(list.list.size()) };
+  std::memcpy(out, head, sizeof(head));
+  out += sizeof(head);
+  std::memcpy(out, list.list.data(), list.list.size() * sizeof(int32_t));
+  return out + list.list.size() * sizeof(int32_t);
+}
+
+const char*
+read_block(const char* in, const char* end, dunedaq::listrev::IntList& list, const std::string& path)
+{
+  int32_t head[3];
+  if (in + sizeof(head) > end) {
+    throw dunedaq::listrev::ListFileError(ERS_HERE, path, "truncated ReversedList record");
+  }
+  std::memcpy(head, in, sizeof(head));
+  in += sizeof(head);
+  auto bytes = static_cast<size_t>(head[2]) * sizeof(int32_t);
+  if (head[2] < 0 || in + bytes > end) {
+    throw dunedaq::listrev::ListFileError(ERS_HERE, path, "truncated ReversedList record");
+  }
+  list.list_id = head[0];
+  list.generator_id = head[1];
+  list.list.resize(head[2]);
+  std::memcpy(list.list.data(), in, bytes);
+  return in + bytes;
+}
+
+std::string
+errno_string(const std::string& what)
+{
+  return what + ": " + std::strerror(errno);
+}
+
+} // namespace
+
+dunedaq::listrev::ListFileWriter::ListFileWriter(const std::string& path, size_t chunk_size)
+  : m_path(path)
+  , m_chunk_size(chunk_size > 0 ? padded(chunk_size) : 64 * 1024 * 1024)
+{
+  m_fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+  if (m_fd < 0) {
+    throw ListFileError(ERS_HERE, path, errno_string("cannot create file"));
+  }
+  remap(sizeof(listfile::FileHeader));
+
+  listfile::FileHeader header;
+  std::memcpy(header.magic, s_file_magic, sizeof(header.magic));
+  header.version = listfile::s_version;
+  header.header_size = sizeof(listfile::FileHeader);
+  std::memcpy(m_map, &header, sizeof(header));
+  m_used = padded(sizeof(header));
+}
+
+dunedaq::listrev::ListFileWriter::~ListFileWriter()
+{
+  try {
+    close();
+  } catch (const ers::Issue& excpt) {
+    ers::error(excpt);
+  }
+}
+
+void
+dunedaq::listrev::ListFileWriter::remap(size_t min_size)
+{
+  // Grow the file a chunk at a time so that most appends are plain stores into the existing mapping
+  auto new_size = m_mapped_size;
+  while (new_size < min_size) {
+    new_size += m_chunk_size;
+  }
+  if (new_size == m_mapped_size) {
+    return;
+  }
+
+  if (m_map != nullptr) {
+    ::munmap(m_map, m_mapped_size);
+    m_map = nullptr;
+  }
+  if (::ftruncate(m_fd, new_size) != 0) {
+    throw ListFileError(ERS_HERE, m_path, errno_string("cannot extend file"));
+  }
+  void* map = ::mmap(nullptr, new_size, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
+  if (map == MAP_FAILED) {
+    throw ListFileError(ERS_HERE, m_path, errno_string("cannot map file"));
+  }
+  m_map = static_cast<char*>(map);
+  m_mapped_size = new_size;
+}
+
+char*
+dunedaq::listrev::ListFileWriter::reserve(ListRecordType type, size_t payload_size, int list_id, int source_id)
+{
+  if (m_fd < 0) {
+    throw ListFileError(ERS_HERE, m_path, "append after close");
+  }
+
+  auto record_size = sizeof(listfile::RecordHeader) + padded(payload_size);
+  remap(m_used + record_size);
+
+  listfile::RecordHeader header;
+  header.type = static_cast<uint32_t>(type); // NOLINT(build/unsigned)
+  header.payload_size = payload_size;
+  header.list_id = list_id;
+  header.source_id = source_id;
+  header.timestamp_ns =
+    std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+
+  char* out = m_map + m_used;
+  std::memcpy(out, &header, sizeof(header));
+  m_index.push_back({ m_used, header.type, list_id, source_id, 0 });
+  m_used += record_size;
+  return out + sizeof(header);
+}
+
+size_t
+dunedaq::listrev::ListFileWriter::append(const IntList& list)
+{
+  auto payload_size = list.list.size() * sizeof(int32_t);
+
+  std::lock_guard<std::mutex> lk(m_mutex);
+  char* out = reserve(ListRecordType::IntList, payload_size, list.list_id, list.generator_id);
+  std::memcpy(out, list.list.data(), payload_size);
+  return sizeof(listfile::RecordHeader) + padded(payload_size);
+}
+
+size_t
+dunedaq::listrev::ListFileWriter::append(const ReversedList& list)
+{
+  size_t payload_size = 2 * sizeof(uint32_t); // NOLINT(build/unsigned)
+  for (auto& data : list.lists) {
+    payload_size += block_size(data.original) + block_size(data.reversed);
+  }
+
+  std::lock_guard<std::mutex> lk(m_mutex);
+  char* out = reserve(ListRecordType::ReversedList, payload_size, list.list_id, list.reverser_id);
+  uint32_t head[2] = { static_cast<uint32_t>(list.lists.size()), 0 }; // NOLINT(build/unsigned)
+  std::memcpy(out, head, sizeof(head));
+  out += sizeof(head);
+  for (auto& data : list.lists) {
+    out = write_block(out, data.original);
+    out = write_block(out, data.reversed);
+  }
+  return sizeof(listfile::RecordHeader) + padded(payload_size);
+}
+
+void
+dunedaq::listrev::ListFileWriter::close()
+{
+  std::lock_guard<std::mutex> lk(m_mutex);
+  if (m_fd < 0) {
+    return;
+  }
+
+  auto index_bytes = m_index.size() * sizeof(listfile::IndexEntry);
+  remap(m_used + index_bytes + sizeof(listfile::FileFooter));
+
+  listfile::FileFooter footer;
+  footer.index_offset = m_used;
+  footer.record_count = m_index.size();
+  std::memcpy(footer.magic, s_footer_magic, sizeof(footer.magic));
+
+  std::memcpy(m_map + m_used, m_index.data(), index_bytes);
+  m_used += index_bytes;
+  std::memcpy(m_map + m_used, &footer, sizeof(footer));
+  m_used += sizeof(footer);
+
+  ::munmap(m_map, m_mapped_size);
+  m_map = nullptr;
+  m_mapped_size = 0;
+  int rc = ::ftruncate(m_fd, m_used);
+  ::close(m_fd);
+  m_fd = -1;
+  if (rc != 0) {
+    throw ListFileError(ERS_HERE, m_path, errno_string("cannot truncate file"));
+  }
+}
+
+size_t
+dunedaq::listrev::ListFileWriter::records() const
+{
+  std::lock_guard<std::mutex> lk(m_mutex);
+  return m_index.size();
+}
+
+dunedaq::listrev::ListFileReader::ListFileReader(const std::string& path)
+  : m_path(path)
+{
+  m_fd = ::open(path.c_str(), O_RDONLY);
+  if (m_fd < 0) {
+    throw ListFileError(ERS_HERE, path, errno_string("cannot open file"));
+  }
+  struct stat st;
+  if (::fstat(m_fd, &st) != 0) {
+    ::close(m_fd);
+    throw ListFileError(ERS_HERE, path, errno_string("cannot stat file"));
+  }
+  m_size = st.st_size;
+  if (m_size < sizeof(listfile::FileHeader)) {
+    ::close(m_fd);
+    throw ListFileError(ERS_HERE, path, "file is too short to be a list file");
+  }
+
+  void* map = ::mmap(nullptr, m_size, PROT_READ, MAP_SHARED, m_fd, 0);
+  if (map == MAP_FAILED) {
+    ::close(m_fd);
+    throw ListFileError(ERS_HERE, path, errno_string("cannot map file"));
+  }
+  m_map = static_cast<const char*>(map);
+
+  listfile::FileHeader header;
+  std::memcpy(&header, m_map, sizeof(header));
+  if (std::memcmp(header.magic, s_file_magic, sizeof(header.magic)) != 0 || header.version != listfile::s_version) {
+    ::munmap(const_cast<char*>(m_map), m_size);
+    ::close(m_fd);
+    throw ListFileError(ERS_HERE, path, "not a list file, or unsupported version");
+  }
+
+  if (!load_index()) {
+    scan_records();
+  }
+}
+
+dunedaq::listrev::ListFileReader::~ListFileReader()
+{
+  ::munmap(const_cast<char*>(m_map), m_size);
+  ::close(m_fd);
+}
+
+bool
+dunedaq::listrev::ListFileReader::load_index()
+{
+  if (m_size < sizeof(listfile::FileHeader) + sizeof(listfile::FileFooter)) {
+    return false;
+  }
+  listfile::FileFooter footer;
+  std::memcpy(&footer, m_map + m_size - sizeof(footer), sizeof(footer));
+  if (std::memcmp(footer.magic, s_footer_magic, sizeof(footer.magic)) != 0 ||
+      footer.index_offset + footer.record_count * sizeof(listfile::IndexEntry) + sizeof(footer) != m_size) {
+    return false;
+  }
+
+  m_records.reserve(footer.record_count);
+  for (size_t idx = 0; idx < footer.record_count; ++idx) {
+    listfile::IndexEntry entry;
+    std::memcpy(&entry, m_map + footer.index_offset + idx * sizeof(entry), sizeof(entry));
+    listfile::RecordHeader header;
+    if (entry.offset + sizeof(header) > footer.index_offset) {
+      m_records.clear();
+      return false;
+    }
+    std::memcpy(&header, m_map + entry.offset, sizeof(header));
+    if (entry.offset + sizeof(header) + header.payload_size > footer.index_offset) {
+      m_records.clear();
+      return false;
+    }
+    m_records.push_back({ static_cast<ListRecordType>(header.type),
+                          header.list_id,
+                          header.source_id,
+                          header.timestamp_ns,
+                          m_map + entry.offset + sizeof(header),
+                          header.payload_size });
+  }
+  return true;
+}
+
+void
+dunedaq::listrev::ListFileReader::scan_records()
+{
+  // No valid index: the writer did not close the file. Keep every complete record; the unused tail of the last
+  // chunk is zero-filled, which ends the scan.
+  size_t offset = padded(sizeof(listfile::FileHeader));
+  listfile::RecordHeader header;
+  while (offset + sizeof(header) <= m_size) {
+    std::memcpy(&header, m_map + offset, sizeof(header));
+    auto type = static_cast<ListRecordType>(header.type);
+    if ((type != ListRecordType::IntList && type != ListRecordType::ReversedList) ||
+        offset + sizeof(header) + header.payload_size > m_size) {
+      break;
+    }
+    m_records.push_back(
+      { type, header.list_id, header.source_id, header.timestamp_ns, m_map + offset + sizeof(header), header.payload_size });
+    offset += sizeof(header) + padded(header.payload_size);
+  }
+}
+
+dunedaq::listrev::ListFileReader::IntListView
+dunedaq::listrev::ListFileReader::int_list(size_t index) const
+{
+  auto& rec = m_records.at(index);
+  if (rec.type != ListRecordType::IntList) {
+    throw ListFileError(ERS_HERE, m_path, "record " + std::to_string(index) + " is not an IntList");
+  }
+  // Payloads start 8-byte aligned within a page-aligned mapping, so the elements can be used in place
+  return { rec.list_id, rec.source_id, reinterpret_cast<const int*>(rec.payload), rec.payload_size / sizeof(int32_t) };
+}
+
+dunedaq::listrev::IntList
+dunedaq::listrev::ListFileReader::read_int_list(size_t index) const
+{
+  auto view = int_list(index);
+  IntList list;
+  list.list_id = view.list_id;
+  list.generator_id = view.generator_id;
+  list.list.assign(view.begin(), view.end());
+  return list;
+}
+
+dunedaq::listrev::ReversedList
+dunedaq::listrev::ListFileReader::read_reversed_list(size_t index) const
+{
+  auto& rec = m_records.at(index);
+  if (rec.type != ListRecordType::ReversedList) {
+    throw ListFileError(ERS_HERE, m_path, "record " + std::to_string(index) + " is not a ReversedList");
+  }
+
+  const char* in = rec.payload;
+  const char* end = rec.payload + rec.payload_size;
+  uint32_t head[2]; // NOLINT(build/unsigned)
+  if (in + sizeof(head) > end) {
+    throw ListFileError(ERS_HERE, m_path, "truncated ReversedList record");
+  }
+  std::memcpy(head, in, sizeof(head));
+  in += sizeof(head);
+
+  ReversedList list;
+  list.list_id = rec.list_id;
+  list.reverser_id = rec.source_id;
+  list.lists.resize(head[0]);
+  for (auto& data : list.lists) {
+    in = read_block(in, end, data.original, m_path);
+    in = read_block(in, end, data.reversed, m_path);
+  }
+  return list;
+}
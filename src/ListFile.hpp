@@ -0,0 +1,183 @@
+/**
+ * @file ListFile.hpp
+ *
+ * ListFileWriter and ListFileReader handle the binary list recording format used by ListRecorder and by the replay
+ * mode of RandomDataListGenerator.
+ *
+ * A file is a FileHeader followed by records, each a RecordHeader and a payload padded to 8 bytes. IntList payloads
+ * are the raw elements; ReversedList payloads are the pair count followed by each original and reversed list as
+ * (list_id, generator_id, size, elements). When the writer is closed it appends an index of all records and a
+ * FileFooter; a file without a footer (e.g. after a crash) is recovered by scanning the records.
+ *
+ * Both classes memory-map the file. The reader hands out views into the mapping, so replayed lists are copied
+ * exactly once, from the page cache into the outgoing message.
+ *
+ * This is part of the DUNE DAQ Software Suite, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#ifndef LISTREV_PLUGINS_LISTFILE_HPP_
+#define LISTREV_PLUGINS_LISTFILE_HPP_
+
+#include "ListWrapper.hpp"
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace dunedaq {
+namespace listrev {
+
+enum class ListRecordType : uint32_t // NOLINT(build/unsigned)
+{
+  IntList = 1,
+  ReversedList = 2,
+};
+
+namespace listfile {
+
+constexpr uint32_t s_version = 1; // NOLINT(build/unsigned)
+
+struct FileHeader
+{
+  char magic[8];
+  uint32_t version;     // NOLINT(build/unsigned)
+  uint32_t header_size; // NOLINT(build/unsigned)
+};
+
+struct RecordHeader
+{
+  uint32_t type;         // NOLINT(build/unsigned)
+  uint32_t payload_size; // NOLINT(build/unsigned)
+  int32_t list_id;
+  int32_t source_id; ///< generator_id for IntList, reverser_id for ReversedList
+  int64_t timestamp_ns;
+};
+
+struct IndexEntry
+{
+  uint64_t offset; // NOLINT(build/unsigned)
+  uint32_t type;   // NOLINT(build/unsigned)
+  int32_t list_id;
+  int32_t source_id;
+  uint32_t reserved; // NOLINT(build/unsigned)
+};
+
+struct FileFooter
+{
+  uint64_t index_offset; // NOLINT(build/unsigned)
+  uint64_t record_count; // NOLINT(build/unsigned)
+  char magic[8];
+};
+
+} // namespace listfile
+
+/**
+ * @brief Appends IntList and ReversedList records to a memory-mapped file. append() may be called from several
+ * threads.
+ */
+class ListFileWriter
+{
+public:
+  /**
+   * @brief Create (or truncate) path. The mapping grows in steps of chunk_size bytes.
+   */
+  explicit ListFileWriter(const std::string& path, size_t chunk_size = 64 * 1024 * 1024);
+  ~ListFileWriter();
+
+  ListFileWriter(const ListFileWriter&) = delete;
+  ListFileWriter& operator=(const ListFileWriter&) = delete;
+
+  /**
+   * @return Bytes written for the record, including its header
+   */
+  size_t append(const IntList& list);
+  size_t append(const ReversedList& list);
+
+  /**
+   * @brief Write the index and footer, and truncate the file to its contents. Called by the destructor.
+   */
+  void close();
+
+  size_t records() const;
+  const std::string& path() const { return m_path; }
+
+private:
+  char* reserve(ListRecordType type, size_t payload_size, int list_id, int source_id);
+  void remap(size_t min_size);
+
+  std::string m_path;
+  size_t m_chunk_size;
+  int m_fd{ -1 };
+  char* m_map{ nullptr };
+  size_t m_mapped_size{ 0 };
+  size_t m_used{ 0 };
+  std::vector<listfile::IndexEntry> m_index;
+  mutable std::mutex m_mutex;
+};
+
+/**
+ * @brief Read-only access to a list file. All methods are safe to call concurrently.
+ */
+class ListFileReader
+{
+public:
+  struct Record
+  {
+    ListRecordType type;
+    int list_id;
+    int source_id;
+    int64_t timestamp_ns;
+    const char* payload;
+    size_t payload_size;
+  };
+
+  /**
+   * @brief View of an IntList stored in the file; valid for the lifetime of the reader
+   */
+  struct IntListView
+  {
+    int list_id;
+    int generator_id;
+    const int* data;
+    size_t size;
+
+    const int* begin() const { return data; }
+    const int* end() const { return data + size; }
+  };
+
+  explicit ListFileReader(const std::string& path);
+  ~ListFileReader();
+
+  ListFileReader(const ListFileReader&) = delete;
+  ListFileReader& operator=(const ListFileReader&) = delete;
+
+  size_t size() const { return m_records.size(); }
+  const Record& record(size_t index) const { return m_records[index]; }
+
+  /**
+   * @brief View of record index, which must be an IntList record
+   */
+  IntListView int_list(size_t index) const;
+  IntList read_int_list(size_t index) const;
+  ReversedList read_reversed_list(size_t index) const;
+
+  const std::string& path() const { return m_path; }
+
+private:
+  bool load_index();
+  void scan_records();
+
+  std::string m_path;
+  int m_fd{ -1 };
+  const char* m_map{ nullptr };
+  size_t m_size{ 0 };
+  std::vector<Record> m_records;
+};
+
+} // namespace listrev
+} // namespace dunedaq
+
+#endif // LISTREV_PLUGINS_LISTFILE_HPP_
@@ -0,0 +1,104 @@
+/**
+ * @file ListIdPartition.hpp
+ *
+ * ListIdPartition maps a validator's request sequence (1, 2, 3, ...) to the list ids it owns, so that several
+ * validators can share the generators and reversers without their list ids ever colliding. With Stride, partition
+ * k of N owns ids k+1, k+1+N, k+1+2N, ...; with Range, it owns the block (k*size, (k+1)*size]. A single partition
+ * owns every id, and its ids are the sequence numbers themselves.
+ *
+ * This is part of the DUNE DAQ Software Suite, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#ifndef LISTREV_PLUGINS_LISTIDPARTITION_HPP_
+#define LISTREV_PLUGINS_LISTIDPARTITION_HPP_
+
+#include <limits>
+#include <sstream>
+#include <string>
+
+namespace dunedaq {
+namespace listrev {
+
+class ListIdPartition
+{
+public:
+  enum class Mode
+  {
+    Stride,
+    Range,
+  };
+
+  ListIdPartition() = default;
+
+  /**
+   * @param range_size For Range, ids per partition; 0 divides the positive int range evenly
+   */
+  ListIdPartition(Mode mode, int index, int count, int range_size = 0)
+    : m_mode(mode)
+    , m_index(index)
+    , m_count(count)
+    , m_range_size(range_size > 0 ? range_size : std::numeric_limits<int>::max() / count)
+  {
+  }
+
+  /**
+   * @brief List id of the given (1-based) request sequence number
+   */
+  int list_id(int sequence) const
+  {
+    return m_mode == Mode::Stride ? m_index + 1 + (sequence - 1) * m_count : m_index * m_range_size + sequence;
+  }
+
+  /**
+   * @brief Inverse of list_id(); 0 for an id outside this partition
+   */
+  int sequence(int list_id) const
+  {
+    if (list_id <= 0) {
+      return 0;
+    }
+    if (m_mode == Mode::Stride) {
+      return (list_id - 1) % m_count == m_index ? (list_id - 1) / m_count + 1 : 0;
+    }
+    int offset = list_id - m_index * m_range_size;
+    return offset > 0 && offset <= m_range_size ? offset : 0;
+  }
+
+  bool contains(int list_id) const { return sequence(list_id) != 0; }
+
+  /**
+   * @brief Whether the partition has an id for this sequence number; only a Range partition runs out
+   */
+  bool has_sequence(int sequence) const
+  {
+    return m_mode == Mode::Stride ? sequence <= (std::numeric_limits<int>::max() - m_index - 1) / m_count + 1
+                                  : sequence <= m_range_size;
+  }
+
+  std::string describe() const
+  {
+    std::ostringstream out;
+    out << "partition " << m_index << " of " << m_count;
+    if (m_count > 1) {
+      if (m_mode == Mode::Stride) {
+        out << " (ids " << m_index + 1 << " + n*" << m_count << ")";
+      } else {
+        out << " (ids " << list_id(1) << " to " << list_id(m_range_size) << ")";
+      }
+    }
+    return out.str();
+  }
+
+private:
+  Mode m_mode{ Mode::Stride };
+  int m_index{ 0 };
+  int m_count{ 1 };
+  int m_range_size{ std::numeric_limits<int>::max() };
+};
+
+} // namespace listrev
+} // namespace dunedaq
+
+#endif // LISTREV_PLUGINS_LISTIDPARTITION_HPP_
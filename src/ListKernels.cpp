@@ -0,0 +1,121 @@
+/**
+ * @file ListKernels.cpp List kernel implementations
+ *
+ * This is part of the DUNE DAQ Software Suite, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#include "ListKernels.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <random>
+
+dunedaq::listrev::ListMode
+dunedaq::listrev::list_mode_for_generator(size_t generator_id)
+{
+  return static_cast<ListMode>(generator_id % (static_cast<uint16_t>(ListMode::MAX) + 1)); // NOLINT(build/unsigned)
+}
+
+namespace {
+/**
+ * @brief Value of element idx of a list of the given (non-random) mode
+ */
+int
+pattern_value(dunedaq::listrev::ListMode mode, int list_id, size_t idx)
+{
+  using dunedaq::listrev::ListMode;
+  switch (mode) {
+    case ListMode::Ascending:
+      return list_id + idx;
+    case ListMode::Evens:
+      return (list_id % 2 == 0 ? 0 : 1) + list_id + idx * 2;
+    case ListMode::Odds:
+      return (list_id % 2 == 0 ? 1 : 0) + list_id + idx * 2;
+    case ListMode::Descending:
+      return list_id - idx;
+    case ListMode::Random:
+      break;
+  }
+  return 0;
+}
+} // namespace
+
+void
+dunedaq::listrev::fill_list(ListMode mode, int list_id, std::vector<int>& list, const ParallelPolicy& parallel)
+{
+  if (!parallel.applies(list.size())) {
+    for (size_t idx = 0; idx < list.size(); ++idx) {
+      list[idx] = mode == ListMode::Random ? (rand() % 1000) + 1 : pattern_value(mode, list_id, idx);
+    }
+    return;
+  }
+
+  auto seed = static_cast<uint32_t>(rand()); // NOLINT(build/unsigned)
+  parallel.pool->parallel_for(list.size(), ListWorkPool::s_block_elements, [&](size_t begin, size_t end) {
+    if (mode == ListMode::Random) {
+      std::minstd_rand random(seed + begin);
+      for (size_t idx = begin; idx < end; ++idx) {
+        list[idx] = (random() % 1000) + 1;
+      }
+    } else {
+      for (size_t idx = begin; idx < end; ++idx) {
+        list[idx] = pattern_value(mode, list_id, idx);
+      }
+    }
+  });
+}
+
+void
+dunedaq::listrev::reverse_list(const IntList& list,
+                                int reverser_id,
+                                ReversedList::Data& out,
+                                const ParallelPolicy& parallel)
+{
+  out.reversed.list_id = list.list_id;
+  out.reversed.generator_id = reverser_id;
+  if (!parallel.applies(list.list.size())) {
+    out.original = list;
+    out.reversed.list.assign(list.list.rbegin(), list.list.rend());
+    return;
+  }
+
+  // Copy everything but the elements, then copy and reverse them block by block
+  out.original.list_id = list.list_id;
+  out.original.generator_id = list.generator_id;
+  out.original.trace_id = list.trace_id;
+  out.original.trace_ns = list.trace_ns;
+  out.original.encoding = list.encoding;
+  out.original.encoded = list.encoded;
+  auto size = list.list.size();
+  out.original.list.resize(size);
+  out.reversed.list.resize(size);
+  parallel.pool->parallel_for(size, ListWorkPool::s_block_elements, [&](size_t begin, size_t end) {
+    std::copy(list.list.begin() + begin, list.list.begin() + end, out.original.list.begin() + begin);
+    std::reverse_copy(list.list.begin() + begin, list.list.begin() + end, out.reversed.list.end() - end);
+  });
+}
+
+bool
+dunedaq::listrev::is_reversal(const IntList& original, const IntList& reversed, const ParallelPolicy& parallel)
+{
+  auto size = original.list.size();
+  if (size != reversed.list.size()) {
+    return false;
+  }
+  if (!parallel.applies(size)) {
+    // Compare against the reverse iterators instead of re-reversing a copy
+    return std::equal(original.list.begin(), original.list.end(), reversed.list.rbegin());
+  }
+
+  std::atomic<bool> equal{ true };
+  parallel.pool->parallel_for(size, ListWorkPool::s_block_elements, [&](size_t begin, size_t end) {
+    if (equal.load(std::memory_order_relaxed) &&
+        !std::equal(original.list.begin() + begin, original.list.begin() + end, reversed.list.rbegin() + begin)) {
+      equal.store(false, std::memory_order_relaxed);
+    }
+  });
+  return equal.load();
+}
@@ -0,0 +1,65 @@
+/**
+ * @file ListKernels.hpp
+ *
+ * The per-list work done by the listrev modules, kept free of any DAQ
+ * framework dependency so that the same code runs in the DAQModules and in
+ * the listrev_bench application.
+ *
+ * This is part of the DUNE DAQ Software Suite, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#ifndef LISTREV_PLUGINS_LISTKERNELS_HPP_
+#define LISTREV_PLUGINS_LISTKERNELS_HPP_
+
+#include "ListWorkPool.hpp"
+#include "ListWrapper.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace dunedaq {
+namespace listrev {
+
+/**
+ * @brief Content pattern of generated lists; generator N uses mode N % (MAX + 1)
+ */
+enum class ListMode : uint16_t // NOLINT(build/unsigned)
+{
+  Random = 0,
+  Ascending = 1,
+  Evens = 2,
+  Odds = 3,
+  Descending = 4,
+  MAX = Descending,
+};
+
+ListMode
+list_mode_for_generator(size_t generator_id);
+
+/**
+ * @brief Fill every element of list (which is already sized) for the given mode and list id
+ *
+ * Random lists filled in parallel draw from one generator per block, seeded from rand(), instead of from rand()
+ * itself.
+ */
+void
+fill_list(ListMode mode, int list_id, std::vector<int>& list, const ParallelPolicy& parallel = {});
+
+/**
+ * @brief Store list and its reversal, as produced by reverser_id, in out
+ */
+void
+reverse_list(const IntList& list, int reverser_id, ReversedList::Data& out, const ParallelPolicy& parallel = {});
+
+/**
+ * @brief Whether reversed holds the elements of original in reverse order
+ */
+bool
+is_reversal(const IntList& original, const IntList& reversed, const ParallelPolicy& parallel = {});
+
+} // namespace listrev
+} // namespace dunedaq
+
+#endif // LISTREV_PLUGINS_LISTKERNELS_HPP_
@@ -0,0 +1,918 @@
+/**
+ * @file ListReverser.cpp ListReverser class
+ * implementation, shared by the ListReverser and ListTransformer plugins
+ *
+ * This is part of the DUNE DAQ Software Suite, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#include "listrev/dal/ListReverser.hpp"
+#include "listrev/dal/RandomDataListGenerator.hpp"
+#include "listrev/dal/RandomListGeneratorSet.hpp"
+
+#include "listrev/opmon/list_rev_info.pb.h"
+
+#include "CommonIssues.hpp"
+#include "ListKernels.hpp"
+#include "ListTrace.hpp"
+#include "ListReverser.hpp"
+
+#include "appfwk/ModuleConfiguration.hpp"
+#include "confmodel/Connection.hpp"
+
+#include "iomanager/IOManager.hpp"
+#include "logging/Logging.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <optional>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Name used by TRACE TLOG calls from this source file
+ */
+#define TRACE_NAME "ListReverser" // NOLINT
+#define TLVL_ENTER_EXIT_METHODS 10
+#define TLVL_LIST_REVERSAL 15
+#define TLVL_REQUEST_SENDING 16
+#define TLVL_CONFIGURE 17
+
+namespace dunedaq {
+namespace listrev {
+
+ListReverser::ListReverser(const std::string& name)
+  : DAQModule(name)
+  , m_membership_thread(std::bind(&ListReverser::watch_generators, this, std::placeholders::_1))
+{
+  register_command("start", &ListReverser::do_start);
+  register_command("stop", &ListReverser::do_stop);
+}
+
+void
+ListReverser::init(std::shared_ptr<appfwk::ModuleConfiguration> mcfg)
+{
+  TLOG_DEBUG(TLVL_ENTER_EXIT_METHODS) << get_name() << ": Entering init() method";
+  auto mdal = mcfg->module<dal::ListReverser>(get_name());
+  for (auto con : mdal->get_inputs()) {
+    if (con->get_data_type() == datatype_to_string<IntList>()) {
+      m_list_connection = con->UID();
+    }
+    if (con->get_data_type() == datatype_to_string<RequestList>()) {
+      m_requests = con->UID();
+    }
+    if (con->get_data_type() == datatype_to_string<GeneratorHeartbeat>()) {
+      m_heartbeat_connection = con->UID();
+    }
+  }
+
+  try {
+    get_iom_receiver<IntList>(m_list_connection);
+  } catch (const ers::Issue& excpt) {
+    throw InvalidQueueFatalError(ERS_HERE, get_name(), "input", excpt);
+  }
+  try {
+    get_iom_receiver<RequestList>(m_requests);
+  } catch (const ers::Issue& excpt) {
+    throw InvalidQueueFatalError(ERS_HERE, get_name(), "output", excpt);
+  }
+
+  for (auto con : mdal->get_outputs()) {
+    if (con->get_data_type() == datatype_to_string<RequestList>()) {
+      m_generator_connections.push_back( con->UID());
+    }
+
+  }
+
+  m_send_timeout = std::chrono::milliseconds(mdal->get_send_timeout_ms());
+  m_request_timeout = std::chrono::milliseconds(mdal->get_request_timeout_ms());
+  m_reverser_id = mdal->get_reverser_id();
+  m_broadcast_requests = mdal->get_broadcast_requests();
+  m_num_generators = m_generator_connections.size();
+  m_pending_table_capacity = mdal->get_pending_table_capacity();
+  m_max_pending_lists = mdal->get_max_pending_lists();
+  m_generator_timeout = std::chrono::milliseconds(mdal->get_generator_timeout_ms());
+
+  try {
+    m_callback_placement.configure(mdal->get_callback_cpus(), mdal->get_local_memory());
+  } catch (const ThreadPlacementError& excpt) {
+    throw appfwk::CommandFailed(ERS_HERE, get_name(), "init", "Invalid thread placement", excpt);
+  }
+  m_parallel = shared_pool_policy(mdal->get_parallel_threads(), mdal->get_parallel_threshold());
+  try {
+    m_faults.configure(mdal->get_fault_injection(), get_name());
+  } catch (const FaultInjectionError& excpt) {
+    throw appfwk::CommandFailed(ERS_HERE, get_name(), "init", "Invalid fault injection", excpt);
+  }
+  if (m_faults.active()) {
+    ers::info(ProgressUpdate(ERS_HERE, get_name(), "injecting faults: " + m_faults.describe()));
+  }
+
+  try {
+    m_list_encoding = parse_list_encoding(mdal->get_list_encoding());
+  } catch (const ListEncodingError& excpt) {
+    throw appfwk::CommandFailed(ERS_HERE, get_name(), "init", "Invalid list_encoding", excpt);
+  }
+
+  if (!mdal->get_trace_path().empty()) {
+    try {
+      ListTracer::get().enable(mdal->get_trace_path());
+    } catch (const TraceFileError& excpt) {
+      throw appfwk::CommandFailed(ERS_HERE, get_name(), "init", "Unable to create the trace file", excpt);
+    }
+  }
+  m_trace_track = ListTracer::get().track(get_name());
+  m_host = ShmListRing::local_host();
+
+  if (m_broadcast_requests) {
+    // In broadcast mode the single RequestList output is a pub/sub topic that every generator subscribes to, so the
+    // number of lists to wait for has to come from the generator set rather than from the number of outputs
+    if (m_generator_connections.size() != 1) {
+      throw appfwk::CommandFailed(
+        ERS_HERE, get_name(), "init", "broadcast_requests requires exactly one RequestList output connection");
+    }
+    if (mdal->get_generatorSet() == nullptr) {
+      throw appfwk::CommandFailed(ERS_HERE, get_name(), "init", "broadcast_requests requires a generatorSet");
+    }
+    m_num_generators = mdal->get_generatorSet()->get_generators().size();
+  }
+
+  // With a generator set, each generator's list goes into the slot of its position in the set; without one, the
+  // generator ids are taken to be 0 to m_num_generators - 1
+  m_generator_ids.clear();
+  m_generator_slots.clear();
+  if (mdal->get_generatorSet() != nullptr) {
+    for (auto gen : mdal->get_generatorSet()->get_generators()) {
+      m_generator_ids.push_back(gen->get_generator_id());
+    }
+    auto max_id = m_generator_ids.empty() ? 0 : *std::max_element(m_generator_ids.begin(), m_generator_ids.end());
+    m_generator_slots.assign(max_id + 1, m_num_generators);
+    for (size_t idx = 0; idx < m_generator_ids.size() && idx < m_num_generators; ++idx) {
+      m_generator_slots[m_generator_ids[idx]] = idx;
+    }
+  }
+
+  // With a GeneratorHeartbeat input the generators come and go during the run. Those of the generator set that are
+  // reached through one of the RequestList outputs are members from the start, until their heartbeats say otherwise.
+  m_initial_members.clear();
+  if (!m_heartbeat_connection.empty()) {
+    if (mdal->get_generatorSet() == nullptr) {
+      throw appfwk::CommandFailed(ERS_HERE, get_name(), "init", "A GeneratorHeartbeat input requires a generatorSet");
+    }
+    try {
+      get_iom_receiver<GeneratorHeartbeat>(m_heartbeat_connection);
+    } catch (const ers::Issue& excpt) {
+      throw InvalidQueueFatalError(ERS_HERE, get_name(), "heartbeat input", excpt);
+    }
+    for (auto gen : mdal->get_generatorSet()->get_generators()) {
+      for (auto con : gen->get_inputs()) {
+        if (std::find(m_generator_connections.begin(), m_generator_connections.end(), con->UID()) !=
+            m_generator_connections.end()) {
+          m_initial_members.emplace_back(gen->get_generator_id(), con->UID());
+          break;
+        }
+      }
+    }
+  }
+
+  TLOG_DEBUG(TLVL_CONFIGURE) << "ListReverser " << m_reverser_id << " configured with "
+                             << "send timeout " <<mdal->get_send_timeout_ms() << " ms,"
+                             << " request timeout " << mdal->get_request_timeout_ms() << "ms, "
+                             << " and " << m_num_generators << " generators"
+                             << (m_broadcast_requests ? " (broadcast requests)" : "")
+                             << (m_heartbeat_connection.empty() ? "." : ", membership from heartbeats.");
+
+  TLOG_DEBUG(TLVL_ENTER_EXIT_METHODS) << get_name() << ": Exiting init() method";
+}
+
+void
+ListReverser::generate_opmon_data()
+{
+  opmon::ListReverserInfo fcr;
+
+  auto now = std::chrono::steady_clock::now();
+  double interval_s = std::chrono::duration<double>(now - m_last_opmon_time).count();
+  m_last_opmon_time = now;
+
+  auto requests_received = m_requests_received.snapshot();
+  auto requests_sent = m_requests_sent.snapshot();
+  auto lists_received = m_lists_received.snapshot();
+  auto lists_sent = m_lists_sent.snapshot();
+  auto elements_received = m_elements_received.snapshot();
+  auto bytes_received = m_bytes_received.snapshot();
+  auto bytes_sent = m_bytes_sent.snapshot();
+  auto dropped_lists = m_dropped_lists.snapshot();
+  auto expired_requests = m_expired_requests.snapshot();
+  auto expired_lists = m_expired_lists.snapshot();
+  auto coalesced_requests = m_coalesced_requests.snapshot();
+  auto duplicate_lists = m_duplicate_lists.snapshot();
+  auto generators_joined = m_generators_joined.snapshot();
+  auto generators_left = m_generators_left.snapshot();
+  auto shm_lists = m_shm_lists.snapshot();
+  auto shm_failures = m_shm_failures.snapshot();
+
+  fcr.set_requests_received(requests_received.delta);
+  fcr.set_requests_sent(requests_sent.delta);
+  fcr.set_lists_received(lists_received.delta);
+  fcr.set_lists_sent(lists_sent.delta);
+  fcr.set_total_requests_received(requests_received.total);
+  fcr.set_total_requests_sent(requests_sent.total);
+  fcr.set_total_lists_received(lists_received.total);
+  fcr.set_total_lists_sent(lists_sent.total);
+
+  fcr.set_elements_received(elements_received.delta);
+  fcr.set_total_elements_received(elements_received.total);
+  fcr.set_bytes_received(bytes_received.delta);
+  fcr.set_total_bytes_received(bytes_received.total);
+  fcr.set_bytes_sent(bytes_sent.delta);
+  fcr.set_total_bytes_sent(bytes_sent.total);
+  fcr.set_dropped_lists(dropped_lists.delta);
+  fcr.set_total_dropped_lists(dropped_lists.total);
+  fcr.set_expired_requests(expired_requests.delta);
+  fcr.set_total_expired_requests(expired_requests.total);
+  fcr.set_expired_lists(expired_lists.delta);
+  fcr.set_total_expired_lists(expired_lists.total);
+  fcr.set_coalesced_requests(coalesced_requests.delta);
+  fcr.set_total_coalesced_requests(coalesced_requests.total);
+  fcr.set_duplicate_lists(duplicate_lists.delta);
+  fcr.set_total_duplicate_lists(duplicate_lists.total);
+  fcr.set_generators_joined(generators_joined.delta);
+  fcr.set_total_generators_joined(generators_joined.total);
+  fcr.set_generators_left(generators_left.delta);
+  fcr.set_total_generators_left(generators_left.total);
+  fcr.set_shm_lists(shm_lists.delta);
+  fcr.set_total_shm_lists(shm_lists.total);
+  fcr.set_shm_failures(shm_failures.delta);
+  fcr.set_total_shm_failures(shm_failures.total);
+  {
+    std::lock_guard<std::mutex> lk(m_fanout_mutex);
+    fcr.set_generators(m_fanout ? m_fanout->generators : 0);
+  }
+  if (interval_s > 0) {
+    fcr.set_elements_per_second(elements_received.delta / interval_s);
+    fcr.set_bytes_per_second(bytes_received.delta / interval_s);
+  }
+  if (lists_received.delta > 0) {
+    fcr.set_average_list_size(static_cast<double>(elements_received.delta) / lists_received.delta);
+  }
+  {
+    std::lock_guard<std::mutex> lk(m_map_mutex);
+    fcr.set_pending_lists(m_pending_lists.size());
+  }
+
+  publish(std::move(fcr));
+  if (m_faults.active()) {
+    publish(m_faults.generate_opmon_data());
+  }
+
+  auto publish_stats = [&](const std::string& conn, SendStatistics& stats) {
+    publish(stats.generate_opmon_data(), { { "connection", conn } });
+  };
+  m_request_senders.for_each(publish_stats);
+  m_list_senders.for_each(publish_stats);
+}
+
+void
+ListReverser::do_start(const nlohmann::json& /*startobj*/)
+{
+  TLOG_DEBUG(TLVL_ENTER_EXIT_METHODS) << get_name() << ": Entering do_start() method";
+  {
+    std::lock_guard<std::mutex> lk(m_map_mutex);
+    m_pending_lists.reset(m_pending_table_capacity, m_num_generators);
+    m_credit_requests.clear();
+  }
+  m_assembly_latency.reset();
+  m_run_report.start({ &m_requests_received, &m_lists_received, &m_lists_sent, &m_elements_received,
+                       &m_bytes_received, &m_bytes_sent, &m_dropped_lists, &m_expired_requests, &m_expired_lists,
+                       &m_coalesced_requests, &m_duplicate_lists, &m_generators_joined, &m_generators_left,
+                       &m_shm_lists, &m_shm_failures });
+  m_accept_shm_lists = !m_host.empty();
+  m_membership.reset(m_generator_connections, m_generator_timeout);
+  if (m_heartbeat_connection.empty()) {
+    // With broadcast_requests there is only the pub/sub topic, so one message reaches every generator
+    auto fanout = std::make_shared<FanOut>();
+    for (auto& conn : m_generator_connections) {
+      fanout->senders.push_back(m_request_senders.resolve(conn));
+    }
+    fanout->generators = m_num_generators;
+    std::lock_guard<std::mutex> lk(m_fanout_mutex);
+    m_fanout = fanout;
+  } else {
+    auto now = std::chrono::steady_clock::now();
+    for (auto& [generator_id, conn] : m_initial_members) {
+      m_membership.join(generator_id, conn, now);
+    }
+    update_fanout();
+    get_iomanager()->add_callback<GeneratorHeartbeat>(
+      m_heartbeat_connection, std::bind(&ListReverser::process_heartbeat, this, std::placeholders::_1));
+    m_membership_thread.start_working_thread("membership");
+  }
+
+  if (m_callback_placement.active()) {
+    ers::info(ProgressUpdate(ERS_HERE, get_name(), "callback threads to be placed on " + m_callback_placement.describe()));
+  }
+
+  get_iomanager()->add_callback<IntList>(m_list_connection,
+                                         std::bind(&ListReverser::process_list, this, std::placeholders::_1));
+  get_iomanager()->add_callback<RequestList>(
+    m_requests, std::bind(&ListReverser::process_list_request, this, std::placeholders::_1));
+
+  TLOG() << get_name() << " successfully started";
+  TLOG_DEBUG(TLVL_ENTER_EXIT_METHODS) << get_name() << ": Exiting do_start() method";
+}
+
+void
+ListReverser::do_stop(const nlohmann::json& /*stopobj*/)
+{
+  TLOG_DEBUG(TLVL_ENTER_EXIT_METHODS) << get_name() << ": Entering do_stop() method";
+  get_iomanager()->remove_callback<RequestList>(m_requests);
+  get_iomanager()->remove_callback<IntList>(m_list_connection);
+  if (!m_heartbeat_connection.empty()) {
+    get_iomanager()->remove_callback<GeneratorHeartbeat>(m_heartbeat_connection);
+    if (m_membership_thread.thread_running()) {
+      m_membership_thread.stop_working_thread();
+    }
+  }
+  // Anything still pending was not drained by the validator; it can never be completed now
+  auto dropped = drop_pending_lists();
+  ListTracer::get().flush();
+  {
+    std::lock_guard<std::mutex> lk(m_fanout_mutex);
+    m_fanout.reset();
+  }
+  m_request_senders.clear();
+  m_list_senders.clear();
+  {
+    std::lock_guard<std::mutex> lk(m_shm_mutex);
+    m_shm_rings.clear();
+  }
+  TLOG() << get_name() << " successfully stopped";
+
+  std::ostringstream oss_summ;
+  oss_summ << ": Exiting do_stop() method, received " << m_requests_received.total() << " request messages, "
+           << "sent " << m_requests_sent.total() << ", received " << m_lists_received.total()
+           << " lists, and sent " << m_lists_sent.total() << " reversed list messages, dropped "
+           << m_dropped_lists.total() << " incomplete list sets (" << dropped << " at stop), and shed "
+           << m_expired_requests.total() << " expired requests and " << m_expired_lists.total()
+           << " expired lists; coalesced " << m_coalesced_requests.total() << " repeated requests and discarded "
+           << m_duplicate_lists.total() << " duplicate lists; " << m_generators_joined.total()
+           << " generators joined and " << m_generators_left.total() << " left";
+  ers::info(ProgressUpdate(ERS_HERE, get_name(), oss_summ.str()));
+
+  m_run_report.stop();
+  m_run_report.add_count("requests_received", m_requests_received);
+  m_run_report.add_count("lists_received", m_lists_received);
+  m_run_report.add_rate("lists_per_s", m_lists_received);
+  m_run_report.add_rate("elements_per_s", m_elements_received);
+  m_run_report.add_rate("bytes_received_per_s", m_bytes_received);
+  m_run_report.add_count("list_sets_sent", m_lists_sent);
+  m_run_report.add_rate("list_sets_per_s", m_lists_sent);
+  m_run_report.add_rate("bytes_sent_per_s", m_bytes_sent);
+  m_run_report.add_latency("assembly_latency", m_assembly_latency);
+  m_run_report.add_count("dropped_list_sets", m_dropped_lists);
+  m_run_report.add("dropped_at_stop", dropped);
+  m_run_report.add_count("expired_requests", m_expired_requests);
+  m_run_report.add_count("expired_lists", m_expired_lists);
+  m_run_report.add_count("coalesced_requests", m_coalesced_requests);
+  m_run_report.add_count("duplicate_lists", m_duplicate_lists);
+  m_run_report.add_count("generators_joined", m_generators_joined);
+  m_run_report.add_count("generators_left", m_generators_left);
+  m_run_report.add_count("shm_lists", m_shm_lists);
+  m_run_report.add_count("shm_failures", m_shm_failures);
+  ers::info(EndOfRunReport(ERS_HERE, get_name(), m_run_report.str(get_name())));
+
+  TLOG_DEBUG(TLVL_ENTER_EXIT_METHODS) << get_name() << ": Exiting do_stop() method";
+}
+
+void
+ListReverser::process_list_request(const RequestList& request)
+{
+  TLOG_DEBUG(TLVL_ENTER_EXIT_METHODS) << get_name() << ": Entering process_list_request() method";
+  m_callback_placement.place(get_name(), "request callback");
+  if (request.end_of_requests) {
+    drain(request);
+    return;
+  }
+  ++m_requests_received;
+  if (deadline_passed(request.deadline_ns)) {
+    // The validator has already timed this request out; forwarding it would only load the generators
+    TLOG_DEBUG(TLVL_REQUEST_SENDING) << get_name() << ": Dropping expired request for " << request.list_id;
+    ++m_expired_requests;
+    if (m_max_pending_lists > 0) {
+      std::lock_guard<std::mutex> lk(m_map_mutex);
+      ++m_credit_requests[request.destination];
+    }
+    return;
+  }
+  ListTracer::get().hop(m_trace_track, "request transit", request);
+
+  std::shared_ptr<const FanOut> fanout;
+  {
+    std::lock_guard<std::mutex> lk(m_fanout_mutex);
+    fanout = m_fanout;
+  }
+  if (!fanout) {
+    return;
+  }
+
+  std::optional<OutgoingListSet> empty_set;
+  {
+    std::lock_guard<std::mutex> lk(m_map_mutex);
+    if (m_max_pending_lists > 0) {
+      // Counted with the set it creates, so that the credits of a later list set account for both
+      ++m_credit_requests[request.destination];
+    }
+    auto [pending, created] = m_pending_lists.insert(request.list_id);
+    if (!created) {
+      // The generators have already been asked for this list: a retry, or another requestor, joins the set being
+      // assembled instead of fanning out to every generator again
+      ++m_coalesced_requests;
+      if (!pending->requested_by(request.destination)) {
+        pending->other_requestors.push_back(request.destination);
+      }
+      if (pending->deadline_ns != 0) {
+        pending->deadline_ns = request.deadline_ns == 0 ? 0 : std::max(pending->deadline_ns, request.deadline_ns);
+      }
+      TLOG_DEBUG(TLVL_REQUEST_SENDING) << get_name() << ": Coalesced request for " << request.list_id << " from "
+                                       << request.destination;
+      return;
+    }
+    pending->requestor = request.destination;
+    pending->start_time = std::chrono::steady_clock::now();
+    pending->deadline_ns = request.deadline_ns;
+    pending->list.reverser_id = m_reverser_id;
+    pending->list.trace_id = request.trace_id;
+    pending->list.transforms = m_transforms.codes();
+    pending->expected_lists = fanout->generators;
+    if (!m_heartbeat_connection.empty() && fanout->generators == 0) {
+      // No generator is running: answer at once rather than let the set wait for lists that cannot come
+      empty_set = take_list_set(*pending);
+    }
+  }
+  if (empty_set) {
+    send_list_set(std::move(*empty_set));
+    return;
+  }
+
+  // With broadcast_requests, the fan-out holds only the pub/sub topic, so this loop sends a single message
+  // regardless of the number of subscribed generators
+  for (auto gen_sender : fanout->senders) {
+    TLOG_DEBUG(TLVL_REQUEST_SENDING) << "Sending request for " << request.list_id << " with destination "
+                                     << m_list_connection << " to " << gen_sender->connection;
+    RequestList req(request.list_id, m_list_connection);
+    req.deadline_ns = request.deadline_ns;
+    if (m_accept_shm_lists.load(std::memory_order_relaxed)) {
+      req.host = m_host;
+    }
+    if (request.trace_id != 0) {
+      req.trace_id = request.trace_id;
+      req.trace_ns = ListTracer::now_ns();
+    }
+    SenderCache<RequestList>::send(gen_sender, std::move(req), m_send_timeout);
+    ++m_requests_sent;
+  }
+  TLOG_DEBUG(TLVL_ENTER_EXIT_METHODS) << get_name() << ": Exiting process_list_request() method";
+}
+
+void
+ListReverser::process_list(const IntList& received)
+{
+  TLOG_DEBUG(TLVL_ENTER_EXIT_METHODS) << get_name() << ": Entering process_list() method";
+  m_callback_placement.place(get_name(), "list callback");
+  if (!m_faults.pass()) {
+    TLOG_DEBUG(TLVL_LIST_REVERSAL) << get_name() << ": Injected drop of list #" << received.list_id << " from "
+                                   << received.generator_id;
+    if (!received.shm_ring.empty()) {
+      std::shared_ptr<ShmListRing> ring;
+      {
+        std::lock_guard<std::mutex> lk(m_shm_mutex);
+        auto entry = m_shm_rings.find(received.shm_ring);
+        if (entry != m_shm_rings.end() && entry->second != nullptr && !entry->second->superseded(received)) {
+          ring = entry->second;
+        }
+      }
+      if (ring != nullptr) {
+        ring->release(received);
+      }
+    }
+    return;
+  }
+
+  IntList from_ring;
+  const IntList* payload_list = &received;
+  if (!received.shm_ring.empty()) {
+    if (!read_shm_list(received, from_ring)) {
+      return;
+    }
+    payload_list = &from_ring;
+  }
+
+  IntList scratch;
+  const IntList* decoded_list = payload_list;
+  try {
+    decoded_list = &decoded(*payload_list, scratch);
+  } catch (const ListEncodingError& excpt) {
+    ers::error(excpt);
+    return;
+  }
+  auto& list = *decoded_list;
+
+  std::unique_lock<std::mutex> lk(m_map_mutex);
+  ++m_lists_received;
+  m_elements_received += list.list.size();
+  m_bytes_received += payload_size(*payload_list);
+  TLOG_DEBUG(TLVL_LIST_REVERSAL) << get_name() << ": Received list #" << list.list_id << " from " << list.generator_id
+                                 << ". It has size " << list.list.size() << ". Reversing its contents";
+
+  auto pending = m_pending_lists.find(list.list_id);
+  if (pending == nullptr) {
+    std::ostringstream oss_warn;
+    oss_warn << "process list " << list.list_id << " from generator " << list.generator_id
+             << " (late list receive, no pending request)";
+    ers::warning(dunedaq::iomanager::TimeoutExpired(ERS_HERE, get_name(), oss_warn.str(), m_send_timeout.count()));
+    return;
+  }
+
+  if (pending->has_list_from(list.generator_id)) {
+    // A resent list must not stand in for the list of another generator
+    TLOG_DEBUG(TLVL_LIST_REVERSAL) << get_name() << ": Discarding duplicate list #" << list.list_id << " from "
+                                   << list.generator_id;
+    ++m_duplicate_lists;
+    return;
+  }
+
+  if (deadline_passed(pending->deadline_ns)) {
+    // Nobody is waiting for this set any more: skip the reversal, and forget the set once all its lists are in. The
+    // generator is marked as answered so that a resent copy is discarded as a duplicate, not counted again.
+    pending->mark_list_from(list.generator_id);
+    ++m_expired_lists;
+    if (pending->received_lists + ++pending->expired_lists >= pending->expected_lists) {
+      m_pending_lists.erase(list.list_id);
+      m_pending_cv.notify_all();
+    }
+    return;
+  }
+
+  ListTracer::get().hop(m_trace_track, "list transit", list);
+  auto trace_start = ListTracer::now_ns();
+
+  // Build the pair in place in the preallocated list set instead of copying a temporary
+  auto& this_data = pending->add_list_from(list.generator_id, generator_slot(list.generator_id));
+  if (m_transforms.empty()) {
+    reverse_list(list, m_reverser_id, this_data, m_parallel);
+  } else {
+    m_transforms.apply(list, m_reverser_id, this_data);
+  }
+  if (m_faults.corrupts()) {
+    m_faults.corrupt(this_data.reversed.list);
+  }
+  if (list.trace_id != 0) {
+    ListTracer::get().record(m_trace_track,
+                             m_transforms.empty() ? "reverse" : "transform",
+                             list.trace_id,
+                             list.list_id,
+                             trace_start,
+                             ListTracer::now_ns());
+  }
+
+  std::ostringstream oss_prog;
+  oss_prog << (m_transforms.empty() ? "Reversed" : "Transformed") << " list #" << list.list_id << " from "
+           << list.generator_id << ", new size " << this_data.reversed.list.size() << ". ";
+  ers::debug(ProgressUpdate(ERS_HERE, get_name(), oss_prog.str()));
+
+  if (pending->received_lists >= pending->expected_lists ||
+      std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - pending->start_time) >
+        m_request_timeout) {
+    auto list_set = take_list_set(*pending);
+    lk.unlock();
+    send_list_set(std::move(list_set));
+  }
+
+  TLOG_DEBUG(TLVL_ENTER_EXIT_METHODS) << get_name() << ": Exiting process_list() method";
+}
+
+ListReverser::OutgoingListSet
+ListReverser::take_list_set(PendingList& pending)
+{
+  auto list_id = pending.list.list_id;
+  if (m_max_pending_lists > 0) {
+    // This list set is about to leave the table
+    auto pending_after = m_pending_lists.size() - 1;
+    pending.list.credits = pending_after < m_max_pending_lists ? m_max_pending_lists - pending_after : 0;
+    pending.list.credit_requests = m_credit_requests[pending.requestor];
+  }
+  if (pending.received_lists < pending.expected_lists && !m_generator_ids.empty()) {
+    std::ostringstream missing;
+    for (auto id : pending.missing_generators(m_generator_ids)) {
+      missing << " " << id;
+    }
+    TLOG_DEBUG(TLVL_LIST_REVERSAL) << get_name() << ": Sending list set " << list_id << " without the lists of"
+                                   << " generators" << missing.str();
+  }
+  if (!m_heartbeat_connection.empty()) {
+    // The validator cannot know which generators were running; tell it how many lists to expect
+    pending.list.expected_lists = pending.expected_lists;
+  }
+  m_assembly_latency.record(std::chrono::steady_clock::now() - pending.start_time);
+  pending.compact();
+
+  OutgoingListSet list_set{ std::move(pending.list), std::move(pending.requestor),
+                            std::move(pending.other_requestors), {} };
+  if (m_max_pending_lists > 0) {
+    for (auto& requestor : list_set.other_requestors) {
+      list_set.other_credit_requests.push_back(m_credit_requests[requestor]);
+    }
+  }
+  m_pending_lists.erase(list_id);
+  ++m_sending_lists;
+  return list_set;
+}
+
+void
+ListReverser::send_list_set(OutgoingListSet&& list_set)
+{
+  auto list_id = list_set.list.list_id;
+  encode(list_set.list, m_list_encoding);
+  auto bytes = payload_size(list_set.list);
+  if (list_set.list.trace_id != 0) {
+    list_set.list.trace_ns = ListTracer::now_ns();
+  }
+  for (size_t idx = 0; idx < list_set.other_requestors.size(); ++idx) {
+    auto& requestor = list_set.other_requestors[idx];
+    ReversedList copy(list_set.list);
+    if (idx < list_set.other_credit_requests.size()) {
+      copy.credit_requests = list_set.other_credit_requests[idx];
+    }
+    try {
+      m_list_senders.send(requestor, std::move(copy), m_send_timeout);
+      ++m_lists_sent;
+      m_bytes_sent += bytes;
+    } catch (const dunedaq::iomanager::TimeoutExpired& excpt) {
+      ers::warning(excpt);
+    }
+  }
+
+  // A failed send may have consumed the list set, so every attempt but the last sends a copy
+  constexpr int max_attempts = 100;
+  bool successfullyWasSent = false;
+  for (int attempt = 1; !successfullyWasSent && attempt <= max_attempts; ++attempt) {
+    TLOG_DEBUG(TLVL_LIST_REVERSAL) << get_name() << ": Sending the reversed lists " << list_id;
+    try {
+      m_list_senders.send(list_set.requestor,
+                          attempt < max_attempts ? ReversedList(list_set.list) : std::move(list_set.list),
+                          m_send_timeout);
+      successfullyWasSent = true;
+      ++m_lists_sent;
+      m_bytes_sent += bytes;
+    } catch (const dunedaq::iomanager::TimeoutExpired& excpt) {
+      std::ostringstream oss_warn;
+      oss_warn << "send " << list_id << " to \"" << list_set.requestor << "\"";
+      ers::warning(dunedaq::iomanager::TimeoutExpired(ERS_HERE, get_name(), oss_warn.str(), m_send_timeout.count()));
+    }
+  }
+  if (!successfullyWasSent) {
+    TLOG_DEBUG(TLVL_LIST_REVERSAL) << get_name() << ": Dropping list set " << list_id << " after " << max_attempts
+                                   << " failed sends";
+    ++m_dropped_lists;
+  }
+
+  std::lock_guard<std::mutex> lk(m_map_mutex);
+  --m_sending_lists;
+  m_pending_cv.notify_all();
+}
+
+bool
+ListReverser::read_shm_list(const IntList& descriptor, IntList& list)
+{
+  // Only the lookup is serialized; callbacks copy their payloads out of the rings concurrently
+  std::shared_ptr<ShmListRing> ring;
+  {
+    std::lock_guard<std::mutex> lk(m_shm_mutex);
+    auto& entry = m_shm_rings[descriptor.shm_ring];
+    if (entry != nullptr && entry->superseded(descriptor)) {
+      // The generator has recreated the ring; callbacks still reading from the old mapping keep it until they finish
+      entry.reset();
+    }
+    if (entry == nullptr) {
+      try {
+        entry = ShmListRing::attach(descriptor.shm_ring);
+      } catch (const ShmRingError& excpt) {
+        // The generator has our host name but not our shared memory (a separate container, for instance); ask for
+        // lists through the connections from now on
+        m_shm_rings.erase(descriptor.shm_ring);
+        m_accept_shm_lists = false;
+        ++m_shm_failures;
+        ers::warning(excpt);
+        return false;
+      }
+    }
+    ring = entry;
+  }
+
+  if (!ring->read(descriptor, list)) {
+    // The block was reclaimed before we got to it, its lease having run out
+    TLOG_DEBUG(TLVL_LIST_REVERSAL) << get_name() << ": Unable to read list #" << descriptor.list_id << " from "
+                                   << descriptor.generator_id << " in " << descriptor.shm_ring;
+    ++m_shm_failures;
+    return false;
+  }
+  ++m_shm_lists;
+  return true;
+}
+
+void
+ListReverser::drain(const RequestList& end_of_requests)
+{
+  TLOG_DEBUG(TLVL_ENTER_EXIT_METHODS) << get_name() << ": Entering drain() method";
+  auto start = std::chrono::steady_clock::now();
+  {
+    // Requests arrive in order, so every list set up to the last id is already pending or complete. Other
+    // validators sharing this reverser are not draining, so only the sender's list sets are waited for.
+    std::unique_lock<std::mutex> lk(m_map_mutex);
+    m_pending_cv.wait_until(
+      lk, start + m_request_timeout, [&] {
+        return pending_lists_for(end_of_requests.destination) == 0 && m_sending_lists == 0;
+      });
+  }
+  auto dropped = drop_pending_lists(end_of_requests.destination);
+
+  ReversedList ack;
+  ack.list_id = end_of_requests.list_id;
+  ack.reverser_id = m_reverser_id;
+  ack.drain_ack = true;
+  ack.dropped_lists = dropped;
+  try {
+    m_list_senders.send(end_of_requests.destination, std::move(ack), m_send_timeout);
+  } catch (const dunedaq::iomanager::TimeoutExpired& excpt) {
+    ers::warning(excpt);
+  }
+
+  std::ostringstream oss_prog;
+  oss_prog << "Drained up to list set #" << end_of_requests.list_id << " in "
+           << std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count()
+           << " ms, dropping " << dropped << " incomplete list sets";
+  ers::info(ProgressUpdate(ERS_HERE, get_name(), oss_prog.str()));
+  TLOG_DEBUG(TLVL_ENTER_EXIT_METHODS) << get_name() << ": Exiting drain() method";
+}
+
+size_t
+ListReverser::pending_lists_for(const std::string& requestor)
+{
+  size_t pending_lists = 0;
+  m_pending_lists.for_each([&](PendingList& pending) {
+    if (pending.requested_by(requestor)) {
+      ++pending_lists;
+    }
+  });
+  return pending_lists;
+}
+
+size_t
+ListReverser::drop_pending_lists(const std::string& requestor)
+{
+  std::lock_guard<std::mutex> lk(m_map_mutex);
+  std::vector<int> dropped;
+  m_pending_lists.for_each([&](PendingList& pending) {
+    if (!requestor.empty() && !pending.other_requestors.empty()) {
+      // The set is still wanted by its other requestors; only detach this one
+      auto& others = pending.other_requestors;
+      if (pending.requestor == requestor) {
+        pending.requestor = others.front();
+        others.erase(others.begin());
+      } else {
+        others.erase(std::remove(others.begin(), others.end(), requestor), others.end());
+      }
+      return;
+    }
+    if (requestor.empty() || pending.requestor == requestor) {
+      TLOG_DEBUG(TLVL_LIST_REVERSAL) << get_name() << ": Dropping list set " << pending.list.list_id << " with "
+                                     << pending.received_lists << " of " << pending.expected_lists << " lists";
+      dropped.push_back(pending.list.list_id);
+    }
+  });
+  for (auto id : dropped) {
+    m_pending_lists.erase(id);
+  }
+  m_dropped_lists += dropped.size();
+  return dropped.size();
+}
+
+size_t
+ListReverser::generator_slot(int generator_id) const
+{
+  auto id = static_cast<size_t>(generator_id);
+  if (generator_id < 0) {
+    return m_num_generators;
+  }
+  if (m_generator_slots.empty()) {
+    return id;
+  }
+  return id < m_generator_slots.size() ? m_generator_slots[id] : m_num_generators;
+}
+
+void
+ListReverser::process_heartbeat(const GeneratorHeartbeat& heartbeat)
+{
+  GeneratorMembership::Member member;
+  switch (m_membership.update(heartbeat, std::chrono::steady_clock::now(), member)) {
+    case GeneratorMembership::Change::Joined:
+      ++m_generators_joined;
+      update_fanout();
+      ers::info(ProgressUpdate(ERS_HERE,
+                               get_name(),
+                               "generator " + std::to_string(member.generator_id) + " joined through " +
+                                 member.connection));
+      break;
+    case GeneratorMembership::Change::Left:
+      ++m_generators_left;
+      update_fanout();
+      release_generator(member);
+      ers::info(ProgressUpdate(ERS_HERE, get_name(), "generator " + std::to_string(member.generator_id) + " left"));
+      break;
+    case GeneratorMembership::Change::None:
+      break;
+  }
+}
+
+void
+ListReverser::watch_generators(std::atomic<bool>& running_flag)
+{
+  auto period = std::chrono::milliseconds(100);
+  if (m_generator_timeout.count() > 0) {
+    period = std::min(period, std::max(m_generator_timeout / 4, std::chrono::milliseconds(1)));
+  }
+  while (running_flag.load()) {
+    std::this_thread::sleep_for(period);
+    auto lost = m_membership.expire(std::chrono::steady_clock::now());
+    if (lost.empty()) {
+      continue;
+    }
+    m_generators_left += lost.size();
+    update_fanout();
+    for (auto& member : lost) {
+      ers::warning(GeneratorLost(ERS_HERE, get_name(), member.generator_id, m_generator_timeout.count()));
+      release_generator(member);
+    }
+  }
+}
+
+void
+ListReverser::update_fanout()
+{
+  auto fanout = std::make_shared<FanOut>();
+  auto members = m_membership.members();
+  fanout->generators = members.size();
+  if (m_broadcast_requests) {
+    if (!members.empty()) {
+      fanout->senders.push_back(m_request_senders.resolve(m_generator_connections.front()));
+    }
+  } else {
+    for (auto& member : members) {
+      fanout->senders.push_back(m_request_senders.resolve(member.connection));
+    }
+  }
+  std::lock_guard<std::mutex> lk(m_fanout_mutex);
+  m_fanout = fanout;
+}
+
+void
+ListReverser::release_generator(const GeneratorMembership::Member& member)
+{
+  std::unique_lock<std::mutex> lk(m_map_mutex);
+  std::vector<int> finished;
+  m_pending_lists.for_each([&](PendingList& pending) {
+    // Sets requested before the generator joined never waited for it
+    if (pending.start_time < member.joined || pending.has_list_from(member.generator_id) ||
+        pending.expected_lists == 0) {
+      return;
+    }
+    --pending.expected_lists;
+    if (pending.received_lists + pending.expired_lists >= pending.expected_lists) {
+      finished.push_back(pending.list.list_id);
+    }
+  });
+  std::vector<OutgoingListSet> complete;
+  for (auto id : finished) {
+    auto pending = m_pending_lists.find(id);
+    if (pending->expired_lists > 0 || deadline_passed(pending->deadline_ns)) {
+      m_pending_lists.erase(id);
+      m_pending_cv.notify_all();
+    } else {
+      complete.push_back(take_list_set(*pending));
+    }
+  }
+  lk.unlock();
+  for (auto& list_set : complete) {
+    send_list_set(std::move(list_set));
+  }
+}
+
+} // namespace listrev
+} // namespace dunedaq
+
+// Local Variables:
+// c-basic-offset: 2
+// End:
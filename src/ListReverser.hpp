@@ -0,0 +1,230 @@
+/**
+ * @file ListReverser.hpp
+ *
+ * ListReverser is a simple DAQModule implementation that reads a list
+ * of integers from one queue, reverses their order in the list, and pushes
+ * the reversed list onto another queue.
+ *
+ * The class lives in the listrev library rather than with its plugin so that
+ * ListTransformer can reuse its request and list-set assembly.
+ *
+ * This is part of the DUNE DAQ Software Suite, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#ifndef LISTREV_PLUGINS_LISTREVERSER_HPP_
+#define LISTREV_PLUGINS_LISTREVERSER_HPP_
+
+#include "FaultInjector.hpp"
+#include "GeneratorMembership.hpp"
+#include "LatencyHistogram.hpp"
+#include "ListEncoding.hpp"
+#include "ListWrapper.hpp"
+#include "ListStorage.hpp"
+#include "ListTransforms.hpp"
+#include "PendingListTable.hpp"
+#include "RunReport.hpp"
+#include "SenderCache.hpp"
+#include "ShardedCounter.hpp"
+#include "ShmListRing.hpp"
+#include "ThreadPlacement.hpp"
+#include "ListWorkPool.hpp"
+
+#include "appfwk/DAQModule.hpp"
+#include "iomanager/Receiver.hpp"
+#include "iomanager/Sender.hpp"
+#include "utilities/WorkerThread.hpp"
+
+#include <ers/Issue.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace dunedaq {
+namespace listrev {
+
+/**
+ * @brief ListReverser reads lists of integers from one queue,
+ * reverses the order of the list, and writes out the reversed list.
+ */
+class ListReverser : public dunedaq::appfwk::DAQModule
+{
+public:
+  /**
+   * @brief ListReverser Constructor
+   * @param name Instance name for this ListReverser instance
+   */
+  explicit ListReverser(const std::string& name);
+
+  ListReverser(const ListReverser&) = delete;            ///< ListReverser is not copy-constructible
+  ListReverser& operator=(const ListReverser&) = delete; ///< ListReverser is not copy-assignable
+  ListReverser(ListReverser&&) = delete;                 ///< ListReverser is not move-constructible
+  ListReverser& operator=(ListReverser&&) = delete;      ///< ListReverser is not move-assignable
+
+  void init(std::shared_ptr<appfwk::ModuleConfiguration> mcfg) override;
+
+protected:
+  void generate_opmon_data() override;
+
+  /// Kernels applied to each list instead of reverse_list(); set by ListTransformer
+  TransformChain m_transforms;
+
+private:
+  // Commands
+  void do_start(const nlohmann::json& obj);
+  void do_stop(const nlohmann::json& obj);
+
+  // Callbacks
+  void process_list_request(const RequestList& request);
+  void process_list(const IntList& list);
+  void process_heartbeat(const GeneratorHeartbeat& heartbeat);
+
+  // Threading
+  dunedaq::utilities::WorkerThread m_membership_thread;
+  /**
+   * @brief Drop the generators whose heartbeats have stopped
+   */
+  void watch_generators(std::atomic<bool>& running_flag);
+
+  // Methods
+  /**
+   * @brief Wait up to the request timeout for the pending list sets to complete, discard the rest, and acknowledge
+   * the end-of-requests message to its sender
+   */
+  void drain(const RequestList& end_of_requests);
+  /**
+   * @brief Number of pending list sets requested by requestor; m_map_mutex must be held
+   */
+  size_t pending_lists_for(const std::string& requestor);
+  /**
+   * @brief Discard the pending list sets requested by requestor, or all of them if it is empty
+   */
+  size_t drop_pending_lists(const std::string& requestor = "");
+  /**
+   * @brief Index of the preallocated entry of a list set that holds this generator's list, or m_num_generators if
+   * it has none
+   */
+  size_t generator_slot(int generator_id) const;
+  /// A list set taken out of the table, to be sent without holding m_map_mutex
+  struct OutgoingListSet
+  {
+    ReversedList list;
+    std::string requestor;
+    std::vector<std::string> other_requestors;
+    std::vector<uint64_t> other_credit_requests; ///< ReversedList::credit_requests for each other requestor
+  };
+  /**
+   * @brief Finish a list set and remove it from the table; m_map_mutex must be held. It counts as pending for
+   * drain() until send_list_set() is done with it.
+   */
+  OutgoingListSet take_list_set(PendingList& pending);
+  /**
+   * @brief Send a list set taken from the table to its requestors; m_map_mutex must not be held
+   */
+  void send_list_set(OutgoingListSet&& list_set);
+  /**
+   * @brief Copy the payload of a list passed through a generator's shared-memory ring into list
+   * @return false if it could not be read
+   */
+  bool read_shm_list(const IntList& descriptor, IntList& list);
+  /**
+   * @brief Rebuild m_fanout from the current members
+   */
+  void update_fanout();
+  /**
+   * @brief Stop waiting for a generator that has left in the list sets requested from it, sending those that are
+   * now complete
+   */
+  void release_generator(const GeneratorMembership::Member& member);
+
+  // Data
+  PendingListTable m_pending_lists;
+  mutable std::mutex m_map_mutex;
+  std::condition_variable m_pending_cv;
+  size_t m_sending_lists{ 0 }; ///< Taken from the table but not yet sent; guarded by m_map_mutex
+  /// With max_pending_lists, requests received from each requestor this run; guarded by m_map_mutex
+  std::map<std::string, uint64_t> m_credit_requests; // NOLINT(build/unsigned)
+
+  // Init
+  std::string m_requests;
+  std::string m_list_connection;
+
+  // Configuration
+  std::chrono::milliseconds m_send_timeout{ 100 };
+  std::chrono::milliseconds m_request_timeout{ 1000 };
+  size_t m_reverser_id{ 0 };
+  bool m_broadcast_requests{ false };
+  size_t m_num_generators{ 0 };
+  size_t m_pending_table_capacity{ 1024 };
+  size_t m_max_pending_lists{ 0 };
+  uint32_t m_trace_track{ 0 }; // NOLINT(build/unsigned)
+  ListEncoding m_list_encoding{ ListEncoding::None };
+  ThreadPlacement m_callback_placement;
+  ParallelPolicy m_parallel;
+  FaultInjector m_faults; ///< Applied to each received list
+
+  std::vector<std::string> m_generator_connections;
+  std::vector<int> m_generator_ids;      ///< From the generatorSet, if there is one
+  std::vector<size_t> m_generator_slots; ///< Indexed by generator id; empty if the ids are 0 to m_num_generators - 1
+
+  // Membership
+  /// Where the requests of a list set go, and how many lists to wait for
+  struct FanOut
+  {
+    std::vector<SenderCache<RequestList>::Entry*> senders;
+    size_t generators{ 0 };
+  };
+  std::string m_heartbeat_connection; ///< Empty if the generators are fixed by the configuration
+  std::chrono::milliseconds m_generator_timeout{ 0 };
+  std::vector<std::pair<int, std::string>> m_initial_members; ///< Generator id and RequestList output, from init
+  GeneratorMembership m_membership;
+  std::shared_ptr<const FanOut> m_fanout;
+  std::mutex m_fanout_mutex;
+
+  // Shared memory
+  std::string m_host;
+  std::atomic<bool> m_accept_shm_lists{ true }; ///< Whether requests to the generators carry m_host
+  std::map<std::string, std::shared_ptr<ShmListRing>> m_shm_rings; ///< Attached on first use, by name
+  std::mutex m_shm_mutex;
+
+  // Senders
+  SenderCache<RequestList> m_request_senders;
+  SenderCache<ReversedList> m_list_senders;
+
+  // Monitoring
+  ShardedCounter m_requests_received;
+  ShardedCounter m_requests_sent;
+  ShardedCounter m_lists_received;
+  ShardedCounter m_lists_sent;
+  ShardedCounter m_elements_received;
+  ShardedCounter m_bytes_received;
+  ShardedCounter m_bytes_sent;
+  ShardedCounter m_dropped_lists;
+  ShardedCounter m_expired_requests;
+  ShardedCounter m_expired_lists;
+  ShardedCounter m_coalesced_requests;
+  ShardedCounter m_duplicate_lists;
+  ShardedCounter m_generators_joined;
+  ShardedCounter m_generators_left;
+  ShardedCounter m_shm_lists;
+  ShardedCounter m_shm_failures;
+  LatencyHistogram m_assembly_latency; ///< First request to sending the list set, this run
+  RunReport m_run_report{ "ListReverser" };
+  std::chrono::steady_clock::time_point m_last_opmon_time{ std::chrono::steady_clock::now() };
+};
+} // namespace listrev
+} // namespace dunedaq
+
+#endif // LISTREV_PLUGINS_LISTREVERSER_HPP_
+
+// Local Variables:
+// c-basic-offset: 2
+// End:
@@ -0,0 +1,63 @@
+/**
+ * @file ListSizeSchedule.hpp
+ *
+ * ListSizeSchedule draws the sizes of successive lists. With a non-zero seed
+ * the sequence is reproducible, so a generator can pre-generate the same
+ * sizes that the validator will later ask for.
+ *
+ * This is part of the DUNE DAQ Software Suite, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#ifndef LISTREV_PLUGINS_LISTSIZESCHEDULE_HPP_
+#define LISTREV_PLUGINS_LISTSIZESCHEDULE_HPP_
+
+#include <cstdint>
+#include <random>
+
+namespace dunedaq {
+namespace listrev {
+
+class ListSizeSchedule
+{
+public:
+  /**
+   * @param seed Seed of the size sequence; 0 selects a random seed
+   */
+  ListSizeSchedule(uint32_t seed, int min_list_size, int max_list_size) // NOLINT(build/unsigned)
+    : m_seed(seed)
+  {
+    if (min_list_size < 0) {
+      min_list_size = 1;
+    }
+    if (max_list_size < min_list_size) {
+      max_list_size = min_list_size;
+    }
+    m_size_dist = std::uniform_int_distribution<>{ min_list_size, max_list_size };
+    reset();
+  }
+
+  /**
+   * @brief Restart the sequence from the first size (with a seed), or reseed randomly (without)
+   */
+  void reset()
+  {
+    m_random_generator.seed(m_seed != 0 ? m_seed : std::random_device()());
+    m_size_dist.reset();
+  }
+
+  int next() { return m_size_dist(m_random_generator); }
+
+  bool deterministic() const { return m_seed != 0; }
+
+private:
+  uint32_t m_seed; // NOLINT(build/unsigned)
+  std::mt19937 m_random_generator;
+  std::uniform_int_distribution<> m_size_dist;
+};
+
+} // namespace listrev
+} // namespace dunedaq
+
+#endif // LISTREV_PLUGINS_LISTSIZESCHEDULE_HPP_
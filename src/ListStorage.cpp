@@ -31,13 +31,20 @@ void
 dunedaq::listrev::ListStorage::add_list(IntList list, bool ignoreDuplicates)
 {
   std::lock_guard<std::mutex> lk(m_lists_mutex);
-  if (m_lists.count(list.list_id) && !ignoreDuplicates) {
+  bool exists = m_lists.count(list.list_id);
+  if (exists && !ignoreDuplicates) {
     throw ListExists(ERS_HERE, list.list_id);
   }
+  if (!exists) {
+    m_order.push_back(list.list_id);
+  }
   m_lists[list.list_id] = list;
 
+  // Evict the oldest list rather than the lowest id: with several validators, each owning a partition of the id
+  // space, the lowest ids all belong to one of them
   while (m_lists.size() > m_capacity) {
-    m_lists.erase(m_lists.begin());
+    m_lists.erase(m_order.front());
+    m_order.pop_front();
   }
 }
 
@@ -53,4 +60,5 @@ dunedaq::listrev::ListStorage::flush()
 {
   std::lock_guard<std::mutex> lk(m_lists_mutex);
   m_lists.clear();
+  m_order.clear();
 }
\ No newline at end of file
@@ -13,6 +13,7 @@
 
 #include "ListWrapper.hpp"
 
+#include <deque>
 #include <map>
 #include <mutex>
 #include <vector>
@@ -23,6 +24,8 @@ namespace listrev {
 	class ListStorage
 	{
         public:
+          static constexpr size_t s_default_capacity = 1000;
+
           ListStorage() {}
 
           bool has_list(const int& id) const;
@@ -36,8 +39,9 @@ namespace listrev {
 
         private:
           std::map<int, IntList> m_lists;
+          std::deque<int> m_order; ///< Ids in insertion order
           mutable std::mutex m_lists_mutex;
-          size_t m_capacity{ 1000 };
+          size_t m_capacity{ s_default_capacity };
 	};
 } // namespace listrev
 } // namespace duneadq
@@ -0,0 +1,153 @@
+/**
+ * @file ListTrace.cpp ListTracer implementation
+ *
+ * This is part of the DUNE DAQ Software Suite, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#include "ListTrace.hpp"
+
+#include "CommonIssues.hpp"
+
+#include <unistd.h>
+
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+namespace {
+std::string
+escaped(const std::string& s)
+{
+  std::string out;
+  for (auto c : s) {
+    if (c == '"' || c == '\\') {
+      out += '\\';
+    }
+    out += c;
+  }
+  return out;
+}
+} // namespace
+
+dunedaq::listrev::ListTracer&
+dunedaq::listrev::ListTracer::get()
+{
+  static ListTracer s_tracer;
+  return s_tracer;
+}
+
+void
+dunedaq::listrev::ListTracer::enable(const std::string& directory, size_t capacity)
+{
+  std::lock_guard<std::mutex> lk(m_mutex);
+  if (enabled()) {
+    return;
+  }
+
+  size_t slots = 1;
+  while (slots < capacity) {
+    slots <<= 1;
+  }
+
+  char host[256] = {};
+  gethostname(host, sizeof(host) - 1);
+  std::ostringstream path;
+  path << (directory.empty() ? "." : directory) << "/listrev_trace_" << host << "_" << getpid() << ".json";
+
+  // The closing bracket is optional in the Chrome trace format, which lets every flush simply append
+  std::ofstream out(path.str(), std::ios::trunc);
+  if (!out) {
+    throw TraceFileError(ERS_HERE, path.str(), "cannot be created");
+  }
+  out << "[\n"
+      << R"({"name":"process_name","ph":"M","pid":)" << getpid() << R"(,"args":{"name":"listrev )" << escaped(host)
+      << ":" << getpid() << "\"}},\n";
+
+  m_path = path.str();
+  m_slots.reset(new Slot[slots]);
+  m_mask = slots - 1;
+  m_enabled.store(true, std::memory_order_release);
+}
+
+uint32_t // NOLINT(build/unsigned)
+dunedaq::listrev::ListTracer::track(const std::string& name)
+{
+  std::lock_guard<std::mutex> lk(m_mutex);
+  m_tracks.push_back(name);
+  return m_tracks.size() - 1;
+}
+
+void
+dunedaq::listrev::ListTracer::record(uint32_t track, // NOLINT(build/unsigned)
+                                     const char* name,
+                                     uint64_t trace_id, // NOLINT(build/unsigned)
+                                     int list_id,
+                                     int64_t start_ns,
+                                     int64_t end_ns)
+{
+  if (!enabled()) {
+    return;
+  }
+  auto index = m_head.fetch_add(1, std::memory_order_relaxed);
+  auto& slot = m_slots[index & m_mask];
+
+  // Sequence lock: a reader that sees the same even sequence before and after copying the event got a whole one
+  slot.sequence.store(2 * index + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  slot.event = Event{ name, trace_id, start_ns, end_ns, list_id, track };
+  slot.sequence.store(2 * index + 2, std::memory_order_release);
+}
+
+size_t
+dunedaq::listrev::ListTracer::flush()
+{
+  std::lock_guard<std::mutex> lk(m_mutex);
+  if (!enabled()) {
+    return 0;
+  }
+
+  std::ofstream out(m_path, std::ios::app);
+  if (!out) {
+    ers::warning(TraceFileError(ERS_HERE, m_path, "cannot be opened for appending"));
+    return 0;
+  }
+  out << std::fixed << std::setprecision(3);
+
+  auto pid = getpid();
+  for (; m_tracks_written < m_tracks.size(); ++m_tracks_written) {
+    out << R"({"name":"thread_name","ph":"M","pid":)" << pid << R"(,"tid":)" << m_tracks_written
+        << R"(,"args":{"name":")" << escaped(m_tracks[m_tracks_written]) << "\"}},\n";
+  }
+
+  auto head = m_head.load(std::memory_order_acquire);
+  auto capacity = m_mask + 1;
+  if (head - m_flushed > capacity) {
+    m_lost += head - m_flushed - capacity;
+    m_flushed = head - capacity;
+  }
+
+  size_t written = 0;
+  for (; m_flushed < head; ++m_flushed) {
+    auto& slot = m_slots[m_flushed & m_mask];
+    auto before = slot.sequence.load(std::memory_order_acquire);
+    if (before < 2 * m_flushed + 2) {
+      // Still being written; pick it up at the next flush
+      break;
+    }
+    Event event = slot.event;
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (before != 2 * m_flushed + 2 || slot.sequence.load(std::memory_order_relaxed) != before) {
+      ++m_lost;
+      continue;
+    }
+
+    out << R"({"name":")" << event.name << R"(","cat":"listrev","ph":"X","ts":)" << event.start_ns / 1000.
+        << R"(,"dur":)" << (event.end_ns - event.start_ns) / 1000. << R"(,"pid":)" << pid << R"(,"tid":)"
+        << event.track << R"(,"bind_id":"0x)" << std::hex << event.trace_id << std::dec
+        << R"(","flow_in":true,"flow_out":true,"args":{"list_id":)" << event.list_id << "}},\n";
+    ++written;
+  }
+  return written;
+}
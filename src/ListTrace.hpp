@@ -0,0 +1,128 @@
+/**
+ * @file ListTrace.hpp
+ *
+ * ListTracer records the hops of sampled lists through the pipeline. The validator marks one list in N with a
+ * non-zero trace_id, which every module copies into the messages it sends for that list, together with the time of
+ * sending (trace_ns). Each module records spans for the transit and the processing of traced messages into a
+ * per-process, fixed-size, lock-free ring, which is appended to a Chrome trace (JSON array) file at every stop.
+ * Timestamps use the system clock so that the files of several hosts can be loaded together in Perfetto or
+ * chrome://tracing; all spans of one list share a flow id, so the viewer draws the list's path across modules.
+ *
+ * This is part of the DUNE DAQ Software Suite, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#ifndef LISTREV_PLUGINS_LISTTRACE_HPP_
+#define LISTREV_PLUGINS_LISTTRACE_HPP_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace dunedaq {
+namespace listrev {
+
+class ListTracer
+{
+public:
+  /**
+   * @brief The tracer shared by all modules of this process
+   */
+  static ListTracer& get();
+
+  ListTracer(const ListTracer&) = delete;
+  ListTracer& operator=(const ListTracer&) = delete;
+
+  /**
+   * @brief Start recording into a ring of capacity events (rounded up to a power of two), to be flushed to
+   * <directory>/listrev_trace_<host>_<pid>.json. Only the first call in a process has an effect.
+   */
+  void enable(const std::string& directory, size_t capacity = 1 << 16);
+  bool enabled() const { return m_enabled.load(std::memory_order_acquire); }
+
+  /**
+   * @brief Register a named timeline (shown as a thread in the viewer), normally one per module
+   */
+  uint32_t track(const std::string& name); // NOLINT(build/unsigned)
+
+  /**
+   * @brief Record a span. Never blocks; when the ring is full the oldest unflushed events are overwritten.
+   * @param name Must be a string literal, or otherwise outlive the tracer
+   */
+  void record(uint32_t track, // NOLINT(build/unsigned)
+              const char* name,
+              uint64_t trace_id, // NOLINT(build/unsigned)
+              int list_id,
+              int64_t start_ns,
+              int64_t end_ns);
+
+  /**
+   * @brief Record the transit of a traced message, from its trace_ns to now
+   */
+  template<typename Message>
+  void hop(uint32_t track, const char* name, const Message& msg) // NOLINT(build/unsigned)
+  {
+    if (msg.trace_id != 0 && enabled()) {
+      record(track, name, msg.trace_id, msg.list_id, msg.trace_ns, now_ns());
+    }
+  }
+
+  /**
+   * @brief Append the events recorded since the previous flush to the trace file
+   * @return Number of events written
+   */
+  size_t flush();
+
+  /**
+   * @return Events overwritten before they could be flushed
+   */
+  uint64_t lost() const { return m_lost.load(std::memory_order_relaxed); } // NOLINT(build/unsigned)
+
+  static int64_t now_ns()
+  {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::system_clock::now().time_since_epoch())
+      .count();
+  }
+
+private:
+  ListTracer() = default;
+
+  struct Event
+  {
+    const char* name;
+    uint64_t trace_id; // NOLINT(build/unsigned)
+    int64_t start_ns;
+    int64_t end_ns;
+    int list_id;
+    uint32_t track; // NOLINT(build/unsigned)
+  };
+  struct Slot
+  {
+    /// 2*index+1 while event index is being written, 2*index+2 once it is complete
+    std::atomic<uint64_t> sequence{ 0 }; // NOLINT(build/unsigned)
+    Event event;
+  };
+
+  std::atomic<bool> m_enabled{ false };
+  std::unique_ptr<Slot[]> m_slots;
+  size_t m_mask{ 0 };
+  alignas(64) std::atomic<uint64_t> m_head{ 0 }; // NOLINT(build/unsigned)
+  std::atomic<uint64_t> m_lost{ 0 };             // NOLINT(build/unsigned)
+
+  std::mutex m_mutex; ///< Serialises enable, track and flush
+  std::string m_path;
+  uint64_t m_flushed{ 0 }; // NOLINT(build/unsigned)
+  std::vector<std::string> m_tracks;
+  size_t m_tracks_written{ 0 };
+};
+
+} // namespace listrev
+} // namespace dunedaq
+
+#endif // LISTREV_PLUGINS_LISTTRACE_HPP_
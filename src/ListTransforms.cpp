@@ -0,0 +1,134 @@
+/**
+ * @file ListTransforms.cpp TransformChain implementation
+ *
+ * This is part of the DUNE DAQ Software Suite, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#include "ListTransforms.hpp"
+
+#include "CommonIssues.hpp"
+
+#include <sstream>
+#include <utility>
+
+namespace {
+const char* const s_transform_names[] = { "reverse", "sort", "prefix_sum", "minmax", "histogram" };
+} // namespace
+
+dunedaq::listrev::TransformKind
+dunedaq::listrev::parse_transform_kind(const std::string& name)
+{
+  for (size_t idx = 0; idx <= static_cast<size_t>(TransformKind::MAX); ++idx) {
+    if (name == s_transform_names[idx]) {
+      return static_cast<TransformKind>(idx);
+    }
+  }
+  throw ListTransformError(ERS_HERE, "unknown kernel \"" + name + "\"");
+}
+
+std::string
+dunedaq::listrev::transform_kind_name(TransformKind kind)
+{
+  return s_transform_names[static_cast<size_t>(kind)];
+}
+
+dunedaq::listrev::TransformChain::TransformChain(const std::vector<TransformKind>& kinds)
+{
+  for (auto kind : kinds) {
+    m_codes.push_back(static_cast<uint8_t>(kind)); // NOLINT(build/unsigned)
+    switch (kind) {
+      case TransformKind::Reverse:
+        m_apply.push_back(&Transform<TransformKind::Reverse>::apply);
+        m_check.push_back(&Transform<TransformKind::Reverse>::check);
+        break;
+      case TransformKind::Sort:
+        m_apply.push_back(&Transform<TransformKind::Sort>::apply);
+        m_check.push_back(&Transform<TransformKind::Sort>::check);
+        break;
+      case TransformKind::PrefixSum:
+        m_apply.push_back(&Transform<TransformKind::PrefixSum>::apply);
+        m_check.push_back(&Transform<TransformKind::PrefixSum>::check);
+        break;
+      case TransformKind::MinMax:
+        m_apply.push_back(&Transform<TransformKind::MinMax>::apply);
+        m_check.push_back(&Transform<TransformKind::MinMax>::check);
+        break;
+      case TransformKind::Histogram:
+        m_apply.push_back(&Transform<TransformKind::Histogram>::apply);
+        m_check.push_back(&Transform<TransformKind::Histogram>::check);
+        break;
+    }
+  }
+}
+
+dunedaq::listrev::TransformChain
+dunedaq::listrev::TransformChain::from_names(const std::vector<std::string>& names)
+{
+  std::vector<TransformKind> kinds;
+  for (auto& name : names) {
+    kinds.push_back(parse_transform_kind(name));
+  }
+  return TransformChain(kinds);
+}
+
+dunedaq::listrev::TransformChain
+dunedaq::listrev::TransformChain::from_codes(const std::vector<uint8_t>& codes) // NOLINT(build/unsigned)
+{
+  std::vector<TransformKind> kinds;
+  for (auto code : codes) {
+    if (code > static_cast<uint8_t>(TransformKind::MAX)) { // NOLINT(build/unsigned)
+      throw ListTransformError(ERS_HERE, "unknown kernel identifier " + std::to_string(code));
+    }
+    kinds.push_back(static_cast<TransformKind>(code));
+  }
+  return TransformChain(kinds);
+}
+
+std::string
+dunedaq::listrev::TransformChain::describe() const
+{
+  std::ostringstream out;
+  for (size_t idx = 0; idx < m_codes.size(); ++idx) {
+    out << (idx > 0 ? "," : "") << transform_kind_name(static_cast<TransformKind>(m_codes[idx]));
+  }
+  return out.str();
+}
+
+void
+dunedaq::listrev::TransformChain::apply(const IntList& list, int stage_id, ReversedList::Data& out) const
+{
+  out.original = list;
+  out.reversed.list_id = list.list_id;
+  out.reversed.generator_id = stage_id;
+  if (m_apply.empty()) {
+    out.reversed.list = list.list;
+    return;
+  }
+
+  // Alternate between the output and one scratch buffer so that the last kernel writes the output
+  std::vector<int> scratch;
+  const std::vector<int>* in = &list.list;
+  for (size_t idx = 0; idx < m_apply.size(); ++idx) {
+    auto& target = (m_apply.size() - idx) % 2 == 1 ? out.reversed.list : scratch;
+    m_apply[idx](*in, target);
+    in = &target;
+  }
+}
+
+bool
+dunedaq::listrev::TransformChain::check(const std::vector<int>& original, const std::vector<int>& result) const
+{
+  if (m_check.empty()) {
+    return original == result;
+  }
+  // Rebuild the input of the last kernel, then let that kernel judge the result
+  std::vector<int> input = original;
+  std::vector<int> next;
+  for (size_t idx = 0; idx + 1 < m_apply.size(); ++idx) {
+    m_apply[idx](input, next);
+    std::swap(input, next);
+  }
+  return m_check.back()(input, result);
+}
@@ -0,0 +1,212 @@
+/**
+ * @file ListTransforms.hpp
+ *
+ * The kernels a ListTransformer can apply to each list in place of the plain reversal: reverse, sort, prefix-sum,
+ * min/max reduction and histogram. Each kernel is a specialization of Transform<K> holding the transform itself
+ * and the check the validator uses to accept its output, so adding a kernel means adding one enumerator and one
+ * specialization. A TransformChain applies a configured sequence of kernels, resolving each one to its
+ * specialization once, when the chain is built.
+ *
+ * This is part of the DUNE DAQ Software Suite, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#ifndef LISTREV_PLUGINS_LISTTRANSFORMS_HPP_
+#define LISTREV_PLUGINS_LISTTRANSFORMS_HPP_
+
+#include "ListWrapper.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace dunedaq {
+namespace listrev {
+
+/**
+ * @brief Kernel identifiers, carried in ReversedList::transforms; the values are part of the message format
+ */
+enum class TransformKind : uint8_t // NOLINT(build/unsigned)
+{
+  Reverse = 0,
+  Sort = 1,
+  PrefixSum = 2,
+  MinMax = 3,
+  Histogram = 4,
+  MAX = Histogram,
+};
+
+/**
+ * @brief Parse a kernel name ("reverse", "sort", "prefix_sum", "minmax" or "histogram")
+ * @throws ListTransformError for an unknown name
+ */
+TransformKind
+parse_transform_kind(const std::string& name);
+std::string
+transform_kind_name(TransformKind kind);
+
+template<TransformKind K>
+struct Transform;
+
+template<>
+struct Transform<TransformKind::Reverse>
+{
+  static void apply(const std::vector<int>& in, std::vector<int>& out) { out.assign(in.rbegin(), in.rend()); }
+  static bool check(const std::vector<int>& in, const std::vector<int>& out)
+  {
+    return in.size() == out.size() && std::equal(in.begin(), in.end(), out.rbegin());
+  }
+};
+
+template<>
+struct Transform<TransformKind::Sort>
+{
+  static void apply(const std::vector<int>& in, std::vector<int>& out)
+  {
+    out = in;
+    std::sort(out.begin(), out.end());
+  }
+  static bool check(const std::vector<int>& in, const std::vector<int>& out)
+  {
+    // Sorted, and a permutation of the input
+    if (in.size() != out.size() || !std::is_sorted(out.begin(), out.end())) {
+      return false;
+    }
+    std::vector<int> expected;
+    apply(in, expected);
+    return expected == out;
+  }
+};
+
+/// Running sums wrap around like unsigned arithmetic, so that any input has a well-defined result
+template<>
+struct Transform<TransformKind::PrefixSum>
+{
+  static void apply(const std::vector<int>& in, std::vector<int>& out)
+  {
+    out.resize(in.size());
+    uint32_t sum = 0; // NOLINT(build/unsigned)
+    for (size_t idx = 0; idx < in.size(); ++idx) {
+      sum += static_cast<uint32_t>(in[idx]); // NOLINT(build/unsigned)
+      out[idx] = static_cast<int>(sum);
+    }
+  }
+  static bool check(const std::vector<int>& in, const std::vector<int>& out)
+  {
+    // Each difference of consecutive sums is the corresponding input
+    if (in.size() != out.size()) {
+      return false;
+    }
+    uint32_t previous = 0; // NOLINT(build/unsigned)
+    for (size_t idx = 0; idx < in.size(); ++idx) {
+      auto current = static_cast<uint32_t>(out[idx]); // NOLINT(build/unsigned)
+      if (current - previous != static_cast<uint32_t>(in[idx])) { // NOLINT(build/unsigned)
+        return false;
+      }
+      previous = current;
+    }
+    return true;
+  }
+};
+
+/// { min, max } of the input; an empty input gives an empty output
+template<>
+struct Transform<TransformKind::MinMax>
+{
+  static void apply(const std::vector<int>& in, std::vector<int>& out)
+  {
+    out.clear();
+    if (!in.empty()) {
+      auto [min, max] = std::minmax_element(in.begin(), in.end());
+      out = { *min, *max };
+    }
+  }
+  static bool check(const std::vector<int>& in, const std::vector<int>& out)
+  {
+    if (in.empty()) {
+      return out.empty();
+    }
+    return out.size() == 2 &&
+           std::all_of(in.begin(), in.end(), [&](int value) { return value >= out[0] && value <= out[1]; }) &&
+           std::find(in.begin(), in.end(), out[0]) != in.end() && std::find(in.begin(), in.end(), out[1]) != in.end();
+  }
+};
+
+/// { min, max, count per bin } over s_bins equal bins spanning [min, max]; an empty input gives an empty output
+template<>
+struct Transform<TransformKind::Histogram>
+{
+  static constexpr size_t s_bins = 16;
+
+  static void apply(const std::vector<int>& in, std::vector<int>& out)
+  {
+    out.clear();
+    if (in.empty()) {
+      return;
+    }
+    auto [min, max] = std::minmax_element(in.begin(), in.end());
+    out.assign(s_bins + 2, 0);
+    out[0] = *min;
+    out[1] = *max;
+    int64_t span = static_cast<int64_t>(*max) - *min + 1;
+    for (auto value : in) {
+      ++out[2 + (static_cast<int64_t>(value) - *min) * static_cast<int64_t>(s_bins) / span];
+    }
+  }
+  static bool check(const std::vector<int>& in, const std::vector<int>& out)
+  {
+    std::vector<int> expected;
+    apply(in, expected);
+    return expected == out;
+  }
+};
+
+/**
+ * @brief A sequence of kernels applied one after the other to each list
+ */
+class TransformChain
+{
+public:
+  TransformChain() = default;
+  explicit TransformChain(const std::vector<TransformKind>& kinds);
+
+  /**
+   * @brief Chain from the kernel names configured for a ListTransformer
+   * @throws ListTransformError for an unknown name
+   */
+  static TransformChain from_names(const std::vector<std::string>& names);
+  /**
+   * @brief Chain from the identifiers carried in a ReversedList
+   * @throws ListTransformError for an unknown identifier
+   */
+  static TransformChain from_codes(const std::vector<uint8_t>& codes); // NOLINT(build/unsigned)
+
+  bool empty() const { return m_codes.empty(); }
+  const std::vector<uint8_t>& codes() const { return m_codes; } // NOLINT(build/unsigned)
+  std::string describe() const;
+
+  /**
+   * @brief Store list and the result of the chain, as produced by stage_id, in out
+   */
+  void apply(const IntList& list, int stage_id, ReversedList::Data& out) const;
+
+  /**
+   * @brief Whether result is what the chain makes of original, using the last kernel's check
+   */
+  bool check(const std::vector<int>& original, const std::vector<int>& result) const;
+
+private:
+  using apply_t = void (*)(const std::vector<int>&, std::vector<int>&);
+  using check_t = bool (*)(const std::vector<int>&, const std::vector<int>&);
+
+  std::vector<uint8_t> m_codes; // NOLINT(build/unsigned)
+  std::vector<apply_t> m_apply;
+  std::vector<check_t> m_check;
+};
+
+} // namespace listrev
+} // namespace dunedaq
+
+#endif // LISTREV_PLUGINS_LISTTRANSFORMS_HPP_
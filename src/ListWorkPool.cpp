@@ -0,0 +1,151 @@
+/**
+ * @file ListWorkPool.cpp ListWorkPool implementation
+ *
+ * This is part of the DUNE DAQ Software Suite, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#include "ListWorkPool.hpp"
+
+#include <algorithm>
+
+dunedaq::listrev::ListWorkPool&
+dunedaq::listrev::ListWorkPool::get()
+{
+  static ListWorkPool s_pool;
+  return s_pool;
+}
+
+dunedaq::listrev::ParallelPolicy
+dunedaq::listrev::shared_pool_policy(size_t threads, size_t threshold)
+{
+  if (threads == 0) {
+    return ParallelPolicy();
+  }
+  ListWorkPool::get().reserve(threads);
+  return ParallelPolicy{ &ListWorkPool::get(), threshold };
+}
+
+dunedaq::listrev::ListWorkPool::~ListWorkPool()
+{
+  {
+    std::lock_guard<std::mutex> lk(m_sleep_mutex);
+    m_stopping = true;
+  }
+  m_wake_cv.notify_all();
+  std::lock_guard<std::mutex> lk(m_threads_mutex);
+  for (auto& thread : m_threads) {
+    thread.join();
+  }
+}
+
+void
+dunedaq::listrev::ListWorkPool::reserve(size_t threads)
+{
+  std::lock_guard<std::mutex> lk(m_threads_mutex);
+  threads = std::min(threads, s_max_threads);
+  while (m_threads.size() < threads) {
+    m_threads.emplace_back(&ListWorkPool::work, this, m_threads.size());
+    m_thread_count.store(m_threads.size(), std::memory_order_release);
+  }
+}
+
+void
+dunedaq::listrev::ListWorkPool::parallel_for(size_t count,
+                                             size_t block,
+                                             const std::function<void(size_t, size_t)>& func)
+{
+  auto workers = threads();
+  block = std::max<size_t>(block, 1);
+  if (workers == 0 || count <= block) {
+    func(0, count);
+    return;
+  }
+
+  Job job{ &func, { (count + block - 1) / block } };
+  auto first = m_next_queue.fetch_add(1, std::memory_order_relaxed);
+  auto queue = first;
+  for (size_t begin = 0; begin < count; begin += block, ++queue) {
+    auto& target = m_queues[queue % workers];
+    std::lock_guard<std::mutex> lk(target.mutex);
+    target.tasks.push_back(Task{ &job, begin, std::min(begin + block, count) });
+    m_queued.fetch_add(1, std::memory_order_release);
+  }
+  {
+    // A worker that found no work before the pushes is either waiting now or will see m_queued
+    std::lock_guard<std::mutex> lk(m_sleep_mutex);
+  }
+  m_wake_cv.notify_all();
+
+  // Help until every block of this job has run, possibly running blocks of other jobs meanwhile
+  Task task;
+  while (job.remaining.load(std::memory_order_acquire) > 0) {
+    if (steal(first, s_max_threads, task)) {
+      run(task);
+    } else {
+      std::this_thread::yield();
+    }
+  }
+}
+
+bool
+dunedaq::listrev::ListWorkPool::pop(size_t queue, Task& task)
+{
+  auto& source = m_queues[queue];
+  std::lock_guard<std::mutex> lk(source.mutex);
+  if (source.tasks.empty()) {
+    return false;
+  }
+  task = source.tasks.front();
+  source.tasks.pop_front();
+  m_queued.fetch_sub(1, std::memory_order_relaxed);
+  return true;
+}
+
+bool
+dunedaq::listrev::ListWorkPool::steal(size_t start, size_t skip, Task& task)
+{
+  auto workers = threads();
+  for (size_t idx = 0; idx < workers && m_queued.load(std::memory_order_acquire) > 0; ++idx) {
+    auto queue = (start + idx) % workers;
+    if (queue == skip) {
+      continue;
+    }
+    auto& source = m_queues[queue];
+    std::lock_guard<std::mutex> lk(source.mutex);
+    if (!source.tasks.empty()) {
+      task = source.tasks.back();
+      source.tasks.pop_back();
+      m_queued.fetch_sub(1, std::memory_order_relaxed);
+      m_steals.fetch_add(1, std::memory_order_relaxed);
+      return true;
+    }
+  }
+  return false;
+}
+
+void
+dunedaq::listrev::ListWorkPool::run(const Task& task)
+{
+  (*task.job->func)(task.begin, task.end);
+  // The job may be gone as soon as its count reaches zero
+  task.job->remaining.fetch_sub(1, std::memory_order_acq_rel);
+}
+
+void
+dunedaq::listrev::ListWorkPool::work(size_t index)
+{
+  Task task;
+  while (true) {
+    if (pop(index, task) || steal(index + 1, index, task)) {
+      run(task);
+      continue;
+    }
+    std::unique_lock<std::mutex> lk(m_sleep_mutex);
+    m_wake_cv.wait(lk, [&] { return m_stopping || m_queued.load(std::memory_order_acquire) > 0; });
+    if (m_stopping) {
+      return;
+    }
+  }
+}
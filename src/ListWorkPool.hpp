@@ -0,0 +1,130 @@
+/**
+ * @file ListWorkPool.hpp
+ *
+ * ListWorkPool is a work-stealing thread pool for splitting the work on one very large list into cache-sized
+ * blocks. parallel_for() deals the blocks of a range out to the workers' queues; each worker takes blocks from the
+ * front of its own queue and, once that is empty, steals from the back of the others. The calling thread steals too
+ * while it waits, so a call never waits for a worker that is busy elsewhere, and calls from several modules' callback
+ * threads share the workers.
+ *
+ * This is part of the DUNE DAQ Software Suite, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#ifndef LISTREV_PLUGINS_LISTWORKPOOL_HPP_
+#define LISTREV_PLUGINS_LISTWORKPOOL_HPP_
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace dunedaq {
+namespace listrev {
+
+class ListWorkPool
+{
+public:
+  static constexpr size_t s_max_threads = 256;
+  /// 128 KiB of ints per block: each block's source and destination fit in a typical L2 cache together
+  static constexpr size_t s_block_elements = 32768;
+
+  /**
+   * @brief The pool shared by all modules of this process
+   */
+  static ListWorkPool& get();
+
+  ListWorkPool() = default;
+  ~ListWorkPool();
+
+  ListWorkPool(const ListWorkPool&) = delete;
+  ListWorkPool& operator=(const ListWorkPool&) = delete;
+
+  /**
+   * @brief Start workers until there are at least threads of them (at most s_max_threads); never stops any
+   */
+  void reserve(size_t threads);
+  size_t threads() const { return m_thread_count.load(std::memory_order_acquire); }
+
+  /**
+   * @brief Call func(begin, end) for consecutive blocks of at most block indices covering [0, count), in parallel,
+   * and return when all have run. func must not throw.
+   */
+  void parallel_for(size_t count, size_t block, const std::function<void(size_t, size_t)>& func);
+
+  /**
+   * @brief Number of blocks run by a thread other than the worker they were dealt to
+   */
+  size_t steals() const { return m_steals.load(std::memory_order_relaxed); }
+
+private:
+  struct Job
+  {
+    const std::function<void(size_t, size_t)>* func;
+    std::atomic<size_t> remaining;
+  };
+  struct Task
+  {
+    Job* job;
+    size_t begin;
+    size_t end;
+  };
+  struct alignas(64) Queue
+  {
+    std::mutex mutex;
+    std::deque<Task> tasks;
+  };
+
+  bool pop(size_t queue, Task& task);
+  /**
+   * @brief Take a task from the back of any queue but skip, starting with the one after start
+   */
+  bool steal(size_t start, size_t skip, Task& task);
+  static void run(const Task& task);
+  void work(size_t index);
+
+  std::array<Queue, s_max_threads> m_queues;
+  std::atomic<size_t> m_queued{ 0 };
+  std::atomic<size_t> m_steals{ 0 };
+  std::atomic<size_t> m_thread_count{ 0 };
+  std::atomic<size_t> m_next_queue{ 0 };
+
+  std::mutex m_sleep_mutex;
+  std::condition_variable m_wake_cv;
+  bool m_stopping{ false };
+
+  std::mutex m_threads_mutex;
+  std::vector<std::thread> m_threads;
+};
+
+/**
+ * @brief When a list kernel splits its work over a ListWorkPool; the default is never
+ */
+struct ParallelPolicy
+{
+  ListWorkPool* pool{ nullptr };
+  size_t threshold{ 0 }; ///< Smallest list, in elements, that is split
+
+  bool applies(size_t elements) const
+  {
+    return pool != nullptr && threshold > 0 && elements >= threshold && pool->threads() > 0;
+  }
+};
+
+/**
+ * @brief Policy for a module configured with parallel_threads and parallel_threshold; with threads > 0, grows the
+ * shared pool to at least that many workers
+ */
+ParallelPolicy
+shared_pool_policy(size_t threads, size_t threshold);
+
+} // namespace listrev
+} // namespace dunedaq
+
+#endif // LISTREV_PLUGINS_LISTWORKPOOL_HPP_
@@ -14,6 +14,9 @@
 
 #include "serialization/Serialization.hpp"
 
+#include <chrono>
+#include <cstdint>
+#include <string>
 #include <vector>
 
 namespace dunedaq {
@@ -23,6 +26,14 @@ struct IntList
   int list_id;
   int generator_id;
   std::vector<int> list;
+  uint64_t trace_id{ 0 }; ///< Non-zero for a sampled list; see ListTrace.hpp
+  int64_t trace_ns{ 0 };  ///< With trace_id, system-clock time at which the message was sent
+  uint8_t encoding{ 0 };  ///< ListEncoding of encoded; 0 when the elements are in list
+  std::vector<uint8_t> encoded;
+  /// ShmListRing holding the payload in place of list or encoded; empty when the payload is in the message
+  std::string shm_ring;
+  uint64_t shm_offset{ 0 };   ///< With shm_ring, offset of the payload's block in the ring
+  uint64_t shm_sequence{ 0 }; ///< With shm_ring, sequence number of the block
 
   IntList() = default;
   explicit IntList(const int& id, const int& gid, std::vector<int> const& l)
@@ -32,7 +43,17 @@ struct IntList
   {
   }
 
-  DUNE_DAQ_SERIALIZE(IntList, list_id, generator_id, list);
+  DUNE_DAQ_SERIALIZE(IntList,
+                     list_id,
+                     generator_id,
+                     list,
+                     trace_id,
+                     trace_ns,
+                     encoding,
+                     encoded,
+                     shm_ring,
+                     shm_offset,
+                     shm_sequence);
 };
 
 struct ReversedList
@@ -47,6 +68,16 @@ struct ReversedList
   int list_id;
   int reverser_id;
   std::vector<Data> lists;
+  bool drain_ack{ false }; ///< Reply to an end-of-requests RequestList; carries no lists
+  int dropped_lists{ 0 };  ///< With drain_ack, number of incomplete list sets the reverser discarded
+  int credits{ -1 };       ///< Further list sets the reverser can accept; negative if it does not advertise credits
+  /// With credits, requests from the receiving requestor that the reverser had received when it computed them
+  uint64_t credit_requests{ 0 }; // NOLINT(build/unsigned)
+  uint64_t trace_id{ 0 };  ///< Non-zero for a sampled list; see ListTrace.hpp
+  int64_t trace_ns{ 0 };   ///< With trace_id, system-clock time at which the message was sent
+  /// TransformKind of each kernel a ListTransformer applied in turn to every list; empty for a plain reversal
+  std::vector<uint8_t> transforms;
+  int expected_lists{ 0 }; ///< Lists waited for by a reverser that follows generator heartbeats; otherwise 0
 
   ReversedList() = default;
   ReversedList(const int& id, const int& rid, std::vector<Data> const& ls)
@@ -56,27 +87,46 @@ struct ReversedList
   {
   }
 
-  DUNE_DAQ_SERIALIZE(ReversedList, list_id, reverser_id, lists);
+  DUNE_DAQ_SERIALIZE(ReversedList,
+                     list_id,
+                     reverser_id,
+                     lists,
+                     drain_ack,
+                     dropped_lists,
+                     credits,
+                     credit_requests,
+                     trace_id,
+                     trace_ns,
+                     transforms,
+                     expected_lists);
 };
 
 struct CreateList
 {
   int list_id;
-  uint16_t list_size;
+  uint32_t list_size;
+  int64_t deadline_ns{ 0 }; ///< See deadline_after()
+  uint64_t trace_id{ 0 };   ///< Non-zero for a sampled list; see ListTrace.hpp
+  int64_t trace_ns{ 0 };    ///< With trace_id, system-clock time at which the message was sent
 
   CreateList() = default;
-  CreateList(const int& id, const uint16_t& size)
+  CreateList(const int& id, const uint32_t& size)
     : list_id(id)
     , list_size(size)
   {
   }
 
-  DUNE_DAQ_SERIALIZE(CreateList, list_id, list_size);
+  DUNE_DAQ_SERIALIZE(CreateList, list_id, list_size, deadline_ns, trace_id, trace_ns);
 };
 struct RequestList
 {
   int list_id;
   std::string destination;
+  bool end_of_requests{ false }; ///< No list after list_id will be requested; the receiver drains and acknowledges
+  int64_t deadline_ns{ 0 };      ///< See deadline_after()
+  uint64_t trace_id{ 0 };        ///< Non-zero for a sampled list; see ListTrace.hpp
+  int64_t trace_ns{ 0 };         ///< With trace_id, system-clock time at which the message was sent
+  std::string host;              ///< Host of a requestor that can read lists from a ShmListRing; otherwise empty
 
   RequestList() = default;
   explicit RequestList(const int& id, const std::string& dest)
@@ -85,8 +135,74 @@ struct RequestList
   {
   }
 
-  DUNE_DAQ_SERIALIZE(RequestList, list_id, destination);
+  DUNE_DAQ_SERIALIZE(RequestList, list_id, destination, end_of_requests, deadline_ns, trace_id, trace_ns, host);
 };
+
+/**
+ * @brief Announcement of a generator to the reversers whose requests it serves, repeated while it runs
+ */
+struct GeneratorHeartbeat
+{
+  int generator_id;
+  std::vector<std::string> request_connections; ///< The generator's RequestList inputs
+  bool withdraw{ false };                       ///< The generator is leaving and will serve no further requests
+
+  GeneratorHeartbeat() = default;
+  GeneratorHeartbeat(const int& gid, std::vector<std::string> const& conns)
+    : generator_id(gid)
+    , request_connections(conns.begin(), conns.end())
+  {
+  }
+
+  DUNE_DAQ_SERIALIZE(GeneratorHeartbeat, generator_id, request_connections, withdraw);
+};
+
+/**
+ * @brief Absolute deadline timeout from now, as carried in CreateList and RequestList. Deadlines cross process and
+ * host boundaries, so they use the system clock (nanoseconds since the epoch); 0 means no deadline.
+ */
+inline int64_t
+deadline_after(std::chrono::milliseconds timeout)
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+           (std::chrono::system_clock::now() + timeout).time_since_epoch())
+    .count();
+}
+inline bool
+deadline_passed(int64_t deadline_ns)
+{
+  return deadline_ns != 0 && std::chrono::duration_cast<std::chrono::nanoseconds>(
+                               std::chrono::system_clock::now().time_since_epoch())
+                                 .count() > deadline_ns;
+}
+
+/**
+ * @brief Approximate payload size of each message type, in bytes, used for throughput accounting
+ */
+inline size_t
+payload_size(const IntList& l)
+{
+  return sizeof(l.list_id) + sizeof(l.generator_id) + l.list.size() * sizeof(int) + l.encoded.size();
+}
+inline size_t
+payload_size(const ReversedList& l)
+{
+  size_t size = sizeof(l.list_id) + sizeof(l.reverser_id);
+  for (auto& data : l.lists) {
+    size += payload_size(data.original) + payload_size(data.reversed);
+  }
+  return size;
+}
+inline size_t
+payload_size(const CreateList& l)
+{
+  return sizeof(l.list_id) + sizeof(l.list_size);
+}
+inline size_t
+payload_size(const RequestList& l)
+{
+  return sizeof(l.list_id) + l.destination.size();
+}
 } // namespace listrev
 
 DUNE_DAQ_SERIALIZABLE(listrev::IntList, "IntList");
@@ -94,6 +210,7 @@ DUNE_DAQ_SERIALIZABLE(listrev::ReversedList::Data, "ReversedListData");
 DUNE_DAQ_SERIALIZABLE(listrev::ReversedList, "ReversedList");
 DUNE_DAQ_SERIALIZABLE(listrev::CreateList, "CreateList");
 DUNE_DAQ_SERIALIZABLE(listrev::RequestList, "RequestList");
+DUNE_DAQ_SERIALIZABLE(listrev::GeneratorHeartbeat, "GeneratorHeartbeat");
 } // namespace dunedaq
 
 #endif // LISTREV_PLUGINS_LISTWRAPPER_HPP_
@@ -0,0 +1,158 @@
+/**
+ * @file PendingListTable.cpp PendingListTable implementations
+ *
+ * This is part of the DUNE DAQ Software Suite, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#include "PendingListTable.hpp"
+
+#include <limits>
+#include <utility>
+
+namespace {
+/**
+ * @brief Reset a list to its default state, keeping the capacity of its element buffers
+ */
+void
+recycle(dunedaq::listrev::IntList& list)
+{
+  auto values = std::move(list.list);
+  auto encoded = std::move(list.encoded);
+  list = dunedaq::listrev::IntList();
+  values.clear();
+  encoded.clear();
+  list.list = std::move(values);
+  list.encoded = std::move(encoded);
+}
+} // namespace
+
+void
+dunedaq::listrev::PendingListTable::reset(size_t capacity, size_t lists_per_entry)
+{
+  // Keep the load factor at or below one half so that probe sequences stay short
+  size_t slots = 16;
+  unsigned bits = 4;
+  while (slots < 2 * capacity) {
+    slots <<= 1;
+    ++bits;
+  }
+
+  m_slots.clear();
+  m_slots.resize(slots);
+  m_mask = slots - 1;
+  m_shift = 64 - bits;
+  m_size = 0;
+  m_lists_per_entry = lists_per_entry;
+}
+
+size_t
+dunedaq::listrev::PendingListTable::find_slot(int list_id) const
+{
+  for (size_t idx = home(list_id);; idx = (idx + 1) & m_mask) {
+    auto& slot = m_slots[idx];
+    if (!slot.used) {
+      return std::numeric_limits<size_t>::max();
+    }
+    if (slot.list_id == list_id) {
+      return idx;
+    }
+  }
+}
+
+dunedaq::listrev::PendingList*
+dunedaq::listrev::PendingListTable::find(int list_id)
+{
+  auto idx = find_slot(list_id);
+  return idx == std::numeric_limits<size_t>::max() ? nullptr : &m_slots[idx].entry;
+}
+
+std::pair<dunedaq::listrev::PendingList*, bool>
+dunedaq::listrev::PendingListTable::insert(int list_id)
+{
+  if (2 * (m_size + 1) > m_slots.size()) {
+    grow();
+  }
+
+  size_t idx = home(list_id);
+  for (; m_slots[idx].used; idx = (idx + 1) & m_mask) {
+    if (m_slots[idx].list_id == list_id) {
+      return { &m_slots[idx].entry, false };
+    }
+  }
+
+  auto& slot = m_slots[idx];
+  slot.used = true;
+  slot.list_id = list_id;
+  slot.entry.requestor.clear();
+  slot.entry.other_requestors.clear();
+  slot.entry.deadline_ns = 0;
+  slot.entry.expired_lists = 0;
+  slot.entry.expected_lists = m_lists_per_entry;
+  slot.entry.received_lists = 0;
+  slot.entry.slots = m_lists_per_entry;
+  slot.entry.generators.assign((m_lists_per_entry + 63) / 64, 0);
+  // Reuse the buffers left in the slot by a set that was dropped rather than sent; a sent set took its own along
+  auto lists = std::move(slot.entry.list.lists);
+  slot.entry.list = ReversedList();
+  slot.entry.list.list_id = list_id;
+  lists.resize(m_lists_per_entry);
+  for (auto& data : lists) {
+    recycle(data.original);
+    recycle(data.reversed);
+    data.original.generator_id = PendingList::s_empty_slot;
+  }
+  slot.entry.list.lists = std::move(lists);
+  ++m_size;
+  return { &slot.entry, true };
+}
+
+void
+dunedaq::listrev::PendingListTable::erase(int list_id)
+{
+  auto hole = find_slot(list_id);
+  if (hole == std::numeric_limits<size_t>::max()) {
+    return;
+  }
+
+  // Backward-shift deletion: pull later members of the probe run into the hole, so no tombstones are needed
+  for (size_t idx = (hole + 1) & m_mask; m_slots[idx].used; idx = (idx + 1) & m_mask) {
+    auto want = home(m_slots[idx].list_id);
+    bool movable = (idx > hole) ? (want <= hole || want > idx) : (want <= hole && want > idx);
+    if (movable) {
+      // Swap rather than move, so that the erased entry's buffers stay in the table for a later insert
+      std::swap(m_slots[hole], m_slots[idx]);
+      hole = idx;
+    }
+  }
+  m_slots[hole].used = false;
+  --m_size;
+}
+
+void
+dunedaq::listrev::PendingListTable::clear()
+{
+  for (auto& slot : m_slots) {
+    slot.used = false;
+  }
+  m_size = 0;
+}
+
+void
+dunedaq::listrev::PendingListTable::grow()
+{
+  auto old_slots = std::move(m_slots);
+  reset(old_slots.size(), m_lists_per_entry);
+
+  for (auto& slot : old_slots) {
+    if (slot.used) {
+      size_t idx = home(slot.list_id);
+      while (m_slots[idx].used) {
+        idx = (idx + 1) & m_mask;
+      }
+      m_slots[idx] = std::move(slot);
+      ++m_size;
+    }
+  }
+}
@@ -0,0 +1,192 @@
+/**
+ * @file PendingListTable.hpp
+ *
+ * PendingListTable holds the list sets a ListReverser is assembling, keyed by list id. It is a flat open-addressing
+ * hash table (linear probing with backward-shift deletion) sized up front, so lookups touch contiguous memory and
+ * inserting or erasing a list set does not allocate a node.
+ *
+ * Each list set starts with one preallocated slot per expected generator, indexed by generator id, and a bitmap of
+ * the generators that have delivered, so that placing a list, rejecting a duplicate and checking completion take
+ * constant time however many generators there are.
+ *
+ * The table is not thread-safe; callers serialise access.
+ *
+ * This is part of the DUNE DAQ Software Suite, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#ifndef LISTREV_PLUGINS_PENDINGLISTTABLE_HPP_
+#define LISTREV_PLUGINS_PENDINGLISTTABLE_HPP_
+
+#include "ListWrapper.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace dunedaq {
+namespace listrev {
+
+struct PendingList
+{
+  std::string requestor;
+  std::vector<std::string> other_requestors; ///< Later requestors of the same list id, each sent a copy of the set
+  std::chrono::steady_clock::time_point start_time;
+  int64_t deadline_ns{ 0 };  ///< From the RequestList
+  size_t expired_lists{ 0 }; ///< Lists received after the deadline and discarded unprocessed
+  size_t expected_lists{ 0 }; ///< Number of generators the set was requested from
+  size_t received_lists{ 0 };
+  size_t slots{ 0 }; ///< Number of preallocated entries at the front of list.lists, one per expected generator
+  /// Bitmap, indexed by generator id, of the generators whose list is in the set
+  std::vector<uint64_t> generators; // NOLINT(build/unsigned)
+  ReversedList list;
+
+  bool requested_by(const std::string& name) const
+  {
+    return name == requestor ||
+           std::find(other_requestors.begin(), other_requestors.end(), name) != other_requestors.end();
+  }
+
+  /**
+   * @brief Whether the set already holds a list from this generator
+   */
+  bool has_list_from(int generator_id) const
+  {
+    auto id = static_cast<size_t>(generator_id);
+    return generator_id >= 0 && id / 64 < generators.size() && (generators[id / 64] >> (id % 64) & 1) != 0;
+  }
+
+  /**
+   * @brief Record that this generator has answered, so that has_list_from() rejects any further list from it
+   */
+  void mark_list_from(int generator_id)
+  {
+    if (generator_id >= 0) {
+      auto id = static_cast<size_t>(generator_id);
+      if (id / 64 >= generators.size()) {
+        generators.resize(id / 64 + 1, 0);
+      }
+      generators[id / 64] |= uint64_t{ 1 } << (id % 64); // NOLINT(build/unsigned)
+    }
+  }
+
+  /**
+   * @brief Record a list from this generator and return the entry to store it in: list.lists[slot] if that is one of
+   * the preallocated slots, or a new entry at the end otherwise
+   */
+  ReversedList::Data& add_list_from(int generator_id, size_t slot)
+  {
+    ++received_lists;
+    mark_list_from(generator_id);
+    return slot < slots ? list.lists[slot] : list.lists.emplace_back();
+  }
+
+  /**
+   * @brief Those of the given generator ids whose list is not in the set
+   */
+  std::vector<int> missing_generators(const std::vector<int>& expected) const
+  {
+    std::vector<int> missing;
+    for (auto id : expected) {
+      if (!has_list_from(id)) {
+        missing.push_back(id);
+      }
+    }
+    return missing;
+  }
+
+  /**
+   * @brief Remove the preallocated slots that were never filled, keeping the order of the others; done before a set
+   * is sent
+   */
+  void compact()
+  {
+    size_t kept = 0;
+    for (size_t idx = 0; idx < list.lists.size(); ++idx) {
+      if (idx >= slots || list.lists[idx].original.generator_id != s_empty_slot) {
+        if (kept != idx) {
+          list.lists[kept] = std::move(list.lists[idx]);
+        }
+        ++kept;
+      }
+    }
+    list.lists.resize(kept);
+    slots = 0;
+  }
+
+  /// generator_id of the original in a preallocated slot that has not been filled
+  static constexpr int s_empty_slot = -1;
+};
+
+class PendingListTable
+{
+public:
+  explicit PendingListTable(size_t capacity = 1024, size_t lists_per_entry = 1) { reset(capacity, lists_per_entry); }
+
+  /**
+   * @brief Drop all entries and size the table for the given number of concurrent list sets, each expected to
+   * collect lists_per_entry lists
+   */
+  void reset(size_t capacity, size_t lists_per_entry);
+
+  /**
+   * @brief Find the entry for a list id
+   * @return Pointer to the entry, or nullptr. Invalidated by any later insert() or erase().
+   */
+  PendingList* find(int list_id);
+
+  /**
+   * @brief Find the entry for a list id, creating an empty one (with a slot per expected generator) if there is none
+   * @return Pointer to the entry, and whether it was created. Invalidated by any later insert() or erase().
+   */
+  std::pair<PendingList*, bool> insert(int list_id);
+
+  void erase(int list_id);
+
+  size_t size() const { return m_size; }
+  size_t capacity() const { return m_slots.size(); }
+  void clear();
+
+  /**
+   * @brief Call func(entry) for every entry
+   */
+  template<typename Func>
+  void for_each(Func&& func)
+  {
+    for (auto& slot : m_slots) {
+      if (slot.used) {
+        func(slot.entry);
+      }
+    }
+  }
+
+private:
+  struct Slot
+  {
+    bool used{ false };
+    int list_id{ 0 };
+    PendingList entry;
+  };
+
+  size_t home(int list_id) const
+  {
+    // Fibonacci hashing: ids are mostly consecutive, the multiplication spreads them over the high bits
+    return (static_cast<uint64_t>(static_cast<uint32_t>(list_id)) * 11400714819323198485ull) >> m_shift; // NOLINT
+  }
+  size_t find_slot(int list_id) const;
+  void grow();
+
+  std::vector<Slot> m_slots;
+  size_t m_mask{ 0 };
+  unsigned m_shift{ 0 };
+  size_t m_size{ 0 };
+  size_t m_lists_per_entry{ 1 };
+};
+} // namespace listrev
+} // namespace dunedaq
+
+#endif // LISTREV_PLUGINS_PENDINGLISTTABLE_HPP_
@@ -0,0 +1,114 @@
+/**
+ * @file RequestWindow.cpp RequestWindow implementations
+ *
+ * This is part of the DUNE DAQ Software Suite, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#include "RequestWindow.hpp"
+
+namespace {
+int64_t
+to_ns(std::chrono::steady_clock::time_point tp)
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(tp.time_since_epoch()).count();
+}
+} // namespace
+
+void
+dunedaq::listrev::RequestWindow::reset(size_t max_outstanding, int first_id)
+{
+  // Leave room for completed requests stuck behind an older outstanding one, rounded up to a power of two so that
+  // the slot index is a mask
+  size_t capacity = 16;
+  while (capacity < 2 * max_outstanding) {
+    capacity <<= 1;
+  }
+
+  if (capacity != m_capacity) {
+    m_slots.reset(new Slot[capacity]);
+    m_capacity = capacity;
+    m_mask = capacity - 1;
+  } else {
+    for (size_t idx = 0; idx < m_capacity; ++idx) {
+      m_slots[idx].tag.store(0, std::memory_order_relaxed);
+    }
+  }
+  m_base = first_id;
+  m_next = first_id;
+  m_outstanding.store(0, std::memory_order_release);
+}
+
+void
+dunedaq::listrev::RequestWindow::insert(int id, size_t reverser, std::chrono::steady_clock::time_point sent)
+{
+  auto& s = slot(id);
+  s.sent_ns.store(to_ns(sent), std::memory_order_relaxed);
+  s.reverser.store(reverser, std::memory_order_relaxed);
+  m_outstanding.fetch_add(1, std::memory_order_relaxed);
+  s.tag.store(tag(id, Outstanding), std::memory_order_release);
+  m_next = id + 1;
+}
+
+dunedaq::listrev::RequestWindow::Completion
+dunedaq::listrev::RequestWindow::complete(int id, std::chrono::steady_clock::time_point received)
+{
+  Completion result;
+  if (m_capacity == 0) {
+    return result;
+  }
+
+  auto& s = slot(id);
+  auto expected = tag(id, Outstanding);
+  if (s.tag.load(std::memory_order_acquire) != expected) {
+    result.status = s.tag.load(std::memory_order_relaxed) == tag(id, TimedOut) ? CompletionStatus::Late
+                                                                                : CompletionStatus::Unknown;
+    return result;
+  }
+
+  // Read the request details before claiming the slot; once it is marked done the producer may reuse it
+  auto sent_ns = s.sent_ns.load(std::memory_order_relaxed);
+  auto reverser = s.reverser.load(std::memory_order_relaxed);
+  if (!s.tag.compare_exchange_strong(expected, tag(id, Done), std::memory_order_acq_rel)) {
+    result.status = expected == tag(id, TimedOut) ? CompletionStatus::Late : CompletionStatus::Unknown;
+    return result;
+  }
+  m_outstanding.fetch_sub(1, std::memory_order_release);
+
+  result.status = CompletionStatus::Completed;
+  result.latency = std::chrono::nanoseconds(to_ns(received) - sent_ns);
+  result.reverser = reverser;
+  return result;
+}
+
+size_t
+dunedaq::listrev::RequestWindow::expire(std::chrono::steady_clock::time_point cutoff,
+                                        const std::function<void(int, size_t)>& on_timeout)
+{
+  size_t timed_out = 0;
+  auto cutoff_ns = to_ns(cutoff);
+
+  // Requests are inserted in send-time order, so everything older than cutoff is at the front of the window
+  for (int id = m_base; id != m_next; ++id) {
+    auto& s = slot(id);
+    auto t = s.tag.load(std::memory_order_acquire);
+    if (state_of(t) == Outstanding) {
+      if (s.sent_ns.load(std::memory_order_relaxed) >= cutoff_ns) {
+        break;
+      }
+      if (s.tag.compare_exchange_strong(t, tag(id, TimedOut), std::memory_order_acq_rel)) {
+        m_outstanding.fetch_sub(1, std::memory_order_release);
+        ++timed_out;
+        on_timeout(id, s.reverser.load(std::memory_order_relaxed));
+      }
+    }
+  }
+
+  // Retired slots keep their tag until reused, so a list arriving after its timeout is still recognised as late
+  while (m_base != m_next && state_of(slot(m_base).tag.load(std::memory_order_acquire)) != Outstanding) {
+    ++m_base;
+  }
+
+  return timed_out;
+}
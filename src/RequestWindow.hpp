@@ -0,0 +1,109 @@
+/**
+ * @file RequestWindow.hpp
+ *
+ * RequestWindow tracks the outstanding list requests of a ReversedListValidator. Request ids are dense and
+ * increasing, so they are kept in a fixed-size ring indexed by id, with O(1) insertion and completion and no
+ * allocation per request.
+ *
+ * Threading model: insert(), expire() and reset() are called from a single producer thread (the validator's work
+ * thread), while complete() may be called concurrently from any number of receiver threads without locking.
+ *
+ * This is part of the DUNE DAQ Software Suite, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#ifndef LISTREV_PLUGINS_REQUESTWINDOW_HPP_
+#define LISTREV_PLUGINS_REQUESTWINDOW_HPP_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+namespace dunedaq {
+namespace listrev {
+
+class RequestWindow
+{
+public:
+  enum class CompletionStatus
+  {
+    Completed, ///< The request was outstanding and is now complete
+    Late,      ///< The request had already timed out
+    Unknown,   ///< The id is not (or no longer) in the window, e.g. a duplicate
+  };
+
+  struct Completion
+  {
+    CompletionStatus status{ CompletionStatus::Unknown };
+    std::chrono::steady_clock::duration latency{ 0 };
+    size_t reverser{ 0 };
+  };
+
+  RequestWindow() = default;
+
+  /**
+   * @brief Empty the window and size it for the given number of outstanding requests. The first id inserted
+   * afterwards must be first_id.
+   */
+  void reset(size_t max_outstanding, int first_id);
+
+  /**
+   * @brief Whether id fits in the window, i.e. it is not so far ahead of the oldest unretired request that it would
+   * overwrite it
+   */
+  bool can_insert(int id) const { return static_cast<size_t>(id - m_base) < m_capacity; }
+
+  void insert(int id, size_t reverser, std::chrono::steady_clock::time_point sent);
+
+  Completion complete(int id, std::chrono::steady_clock::time_point received);
+
+  /**
+   * @brief Mark every outstanding request sent before cutoff as timed out, calling on_timeout(id, reverser) for each,
+   * and retire finished requests from the front of the window. Only the requests older than cutoff are visited.
+   * @return Number of requests that timed out
+   */
+  size_t expire(std::chrono::steady_clock::time_point cutoff, const std::function<void(int, size_t)>& on_timeout);
+
+  size_t outstanding() const { return m_outstanding.load(std::memory_order_acquire); }
+  size_t capacity() const { return m_capacity; }
+
+private:
+  enum State : uint64_t // NOLINT(build/unsigned)
+  {
+    Free = 0,
+    Outstanding = 1,
+    Done = 2,
+    TimedOut = 3,
+  };
+
+  // The id and state share one atomic word so that a completion can never be applied to a later request that
+  // reuses the same slot
+  static uint64_t tag(int id, State state) // NOLINT(build/unsigned)
+  {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(id)) << 8) | state; // NOLINT(build/unsigned)
+  }
+  static State state_of(uint64_t t) { return static_cast<State>(t & 0xff); } // NOLINT(build/unsigned)
+
+  struct Slot
+  {
+    std::atomic<uint64_t> tag{ 0 };    // NOLINT(build/unsigned)
+    std::atomic<int64_t> sent_ns{ 0 }; // steady_clock ticks since epoch
+    std::atomic<size_t> reverser{ 0 };
+  };
+
+  Slot& slot(int id) { return m_slots[static_cast<size_t>(id) & m_mask]; }
+
+  std::unique_ptr<Slot[]> m_slots;
+  size_t m_capacity{ 0 };
+  size_t m_mask{ 0 };
+  int m_base{ 0 }; ///< Oldest id not yet retired; producer thread only
+  int m_next{ 0 }; ///< One past the newest inserted id; producer thread only
+  std::atomic<size_t> m_outstanding{ 0 };
+};
+} // namespace listrev
+} // namespace dunedaq
+
+#endif // LISTREV_PLUGINS_REQUESTWINDOW_HPP_
@@ -0,0 +1,94 @@
+/**
+ * @file RunReport.cpp RunReport implementation
+ *
+ * This is part of the DUNE DAQ Software Suite, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#include "RunReport.hpp"
+
+#include <cmath>
+
+namespace {
+double
+round_to(double value, double step)
+{
+  return std::round(value / step) * step;
+}
+} // namespace
+
+void
+dunedaq::listrev::RunReport::start(std::initializer_list<const ShardedCounter*> counters)
+{
+  m_start = std::chrono::steady_clock::now();
+  m_stop = m_start;
+  m_totals.clear();
+  for (auto counter : counters) {
+    auto total = counter->total();
+    m_totals[counter] = Totals{ total, total };
+  }
+  m_values = nlohmann::json::object();
+}
+
+void
+dunedaq::listrev::RunReport::stop()
+{
+  m_stop = std::chrono::steady_clock::now();
+  for (auto& [counter, totals] : m_totals) {
+    totals.stop = counter->total();
+  }
+}
+
+double
+dunedaq::listrev::RunReport::seconds() const
+{
+  return std::chrono::duration<double>(m_stop - m_start).count();
+}
+
+uint64_t // NOLINT(build/unsigned)
+dunedaq::listrev::RunReport::count(const ShardedCounter& counter) const
+{
+  auto it = m_totals.find(&counter);
+  if (it == m_totals.end()) {
+    return counter.total();
+  }
+  return it->second.stop - it->second.start;
+}
+
+void
+dunedaq::listrev::RunReport::add_count(const std::string& key, const ShardedCounter& counter)
+{
+  m_values[key] = count(counter);
+}
+
+void
+dunedaq::listrev::RunReport::add_rate(const std::string& key, const ShardedCounter& counter)
+{
+  auto run_seconds = seconds();
+  m_values[key] = run_seconds > 0 ? round_to(count(counter) / run_seconds, 0.01) : 0.0;
+}
+
+void
+dunedaq::listrev::RunReport::add_latency(const std::string& key, const LatencyHistogram& latency)
+{
+  nlohmann::json values;
+  values["count"] = latency.count();
+  values["mean_us"] = round_to(latency.mean_ns() / 1000, 0.1);
+  values["p50_us"] = round_to(latency.percentile_ns(50) / 1000.0, 0.1);
+  values["p90_us"] = round_to(latency.percentile_ns(90) / 1000.0, 0.1);
+  values["p99_us"] = round_to(latency.percentile_ns(99) / 1000.0, 0.1);
+  values["p999_us"] = round_to(latency.percentile_ns(99.9) / 1000.0, 0.1);
+  values["max_us"] = round_to(latency.max_ns() / 1000.0, 0.1);
+  m_values[key] = values;
+}
+
+std::string
+dunedaq::listrev::RunReport::str(const std::string& module_name) const
+{
+  nlohmann::json report = m_values;
+  report["module"] = module_name;
+  report["class"] = m_module_class;
+  report["run_seconds"] = round_to(seconds(), 0.001);
+  return report.dump();
+}
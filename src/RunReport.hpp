@@ -0,0 +1,97 @@
+/**
+ * @file RunReport.hpp
+ *
+ * RunReport collects a module's performance over one run into a JSON object, which the module publishes as an
+ * EndOfRunReport at stop for the integration tests and other tools to parse. Counts are the increase of a
+ * ShardedCounter between start() and stop(), so that the totals kept across runs for the stop summary and opmon
+ * can be reused; rates divide them by the length of the run. Values are added after stop(), so that work a module
+ * does while stopping is not counted in the run.
+ *
+ * This is part of the DUNE DAQ Software Suite, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#ifndef LISTREV_PLUGINS_RUNREPORT_HPP_
+#define LISTREV_PLUGINS_RUNREPORT_HPP_
+
+#include "LatencyHistogram.hpp"
+#include "ShardedCounter.hpp"
+
+#include "nlohmann/json.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <initializer_list>
+#include <map>
+#include <string>
+#include <utility>
+
+namespace dunedaq {
+namespace listrev {
+
+class RunReport
+{
+public:
+  explicit RunReport(std::string module_class)
+    : m_module_class(std::move(module_class))
+  {
+  }
+
+  /**
+   * @brief Begin a run: forget the previous report and record the current totals of the counters it will use
+   */
+  void start(std::initializer_list<const ShardedCounter*> counters);
+
+  /**
+   * @brief End the run: record the time and the totals of the counters passed to start()
+   */
+  void stop();
+
+  double seconds() const;
+
+  /**
+   * @brief Increase of counter from start() to stop()
+   */
+  uint64_t count(const ShardedCounter& counter) const; // NOLINT(build/unsigned)
+
+  void add_count(const std::string& key, const ShardedCounter& counter);
+
+  /**
+   * @brief Add the increase of counter during the run, per second of the run
+   */
+  void add_rate(const std::string& key, const ShardedCounter& counter);
+
+  /**
+   * @brief Add the count, mean and percentiles of latency, in microseconds
+   */
+  void add_latency(const std::string& key, const LatencyHistogram& latency);
+
+  template<typename T>
+  void add(const std::string& key, const T& value)
+  {
+    m_values[key] = value;
+  }
+
+  /**
+   * @brief The report as a single line of JSON
+   */
+  std::string str(const std::string& module_name) const;
+
+private:
+  std::string m_module_class;
+  std::chrono::steady_clock::time_point m_start;
+  std::chrono::steady_clock::time_point m_stop;
+  struct Totals
+  {
+    uint64_t start{ 0 }; // NOLINT(build/unsigned)
+    uint64_t stop{ 0 };  // NOLINT(build/unsigned)
+  };
+  std::map<const ShardedCounter*, Totals> m_totals;
+  nlohmann::json m_values;
+};
+
+} // namespace listrev
+} // namespace dunedaq
+
+#endif // LISTREV_PLUGINS_RUNREPORT_HPP_
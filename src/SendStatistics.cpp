@@ -0,0 +1,68 @@
+/**
+ * @file SendStatistics.cpp SendStatistics implementations
+ *
+ * This is part of the DUNE DAQ Software Suite, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#include "SendStatistics.hpp"
+
+void
+dunedaq::listrev::SendStatistics::record_send(size_t bytes, std::chrono::steady_clock::duration send_time)
+{
+  ++m_messages;
+  m_bytes += bytes;
+  record_time(send_time);
+}
+
+void
+dunedaq::listrev::SendStatistics::record_timeout(std::chrono::steady_clock::duration send_time)
+{
+  ++m_timeouts;
+  record_time(send_time);
+}
+
+void
+dunedaq::listrev::SendStatistics::record_time(std::chrono::steady_clock::duration send_time)
+{
+  uint64_t us = std::chrono::duration_cast<std::chrono::microseconds>(send_time).count(); // NOLINT(build/unsigned)
+  m_send_time_us += us;
+
+  // A plain load in the common case; the compare-exchange only runs for a new maximum
+  auto max = m_max_send_time_us.load(std::memory_order_relaxed);
+  while (us > max && !m_max_send_time_us.compare_exchange_weak(max, us, std::memory_order_relaxed)) {
+  }
+
+  size_t bin = 0;
+  while (bin < s_bin_edges_us.size() && us >= s_bin_edges_us[bin]) {
+    ++bin;
+  }
+  ++m_histogram[bin];
+}
+
+dunedaq::listrev::opmon::SendStatisticsInfo
+dunedaq::listrev::SendStatistics::generate_opmon_data()
+{
+  opmon::SendStatisticsInfo info;
+
+  auto messages = m_messages.snapshot().delta;
+  auto timeouts = m_timeouts.snapshot().delta;
+  auto send_time = m_send_time_us.snapshot().delta;
+
+  info.set_messages_sent(messages);
+  info.set_bytes_sent(m_bytes.snapshot().delta);
+  info.set_send_timeouts(timeouts);
+  if (messages + timeouts > 0) {
+    info.set_average_send_time_us(static_cast<double>(send_time) / (messages + timeouts));
+  }
+  info.set_max_send_time_us(m_max_send_time_us.exchange(0));
+
+  info.set_send_time_below_10us(m_histogram[0].snapshot().delta);
+  info.set_send_time_below_100us(m_histogram[1].snapshot().delta);
+  info.set_send_time_below_1ms(m_histogram[2].snapshot().delta);
+  info.set_send_time_below_10ms(m_histogram[3].snapshot().delta);
+  info.set_send_time_above_10ms(m_histogram[4].snapshot().delta);
+
+  return info;
+}
@@ -0,0 +1,60 @@
+/**
+ * @file SendStatistics.hpp
+ *
+ * SendStatistics accumulates per-connection send counters and a coarse send-time histogram. The counters are
+ * ShardedCounters, since every thread that sends on a connection updates them.
+ *
+ * This is part of the DUNE DAQ Software Suite, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#ifndef LISTREV_PLUGINS_SENDSTATISTICS_HPP_
+#define LISTREV_PLUGINS_SENDSTATISTICS_HPP_
+
+#include "ShardedCounter.hpp"
+
+#include "listrev/opmon/list_rev_info.pb.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace dunedaq {
+namespace listrev {
+
+class SendStatistics
+{
+public:
+  SendStatistics() = default;
+  SendStatistics(const SendStatistics&) = delete;
+  SendStatistics& operator=(const SendStatistics&) = delete;
+
+  void record_send(size_t bytes, std::chrono::steady_clock::duration send_time);
+  void record_timeout(std::chrono::steady_clock::duration send_time);
+
+  /**
+   * @brief Fill an opmon message with the statistics accumulated since the previous call. Must only be called from
+   * one thread at a time (the monitoring thread).
+   */
+  opmon::SendStatisticsInfo generate_opmon_data();
+
+private:
+  void record_time(std::chrono::steady_clock::duration send_time);
+
+  // Upper edges of the send-time histogram bins, in microseconds; the last bin is open-ended
+  static constexpr std::array<uint64_t, 4> s_bin_edges_us{ 10, 100, 1000, 10000 }; // NOLINT(build/unsigned)
+
+  ShardedCounter m_messages;
+  ShardedCounter m_bytes;
+  ShardedCounter m_timeouts;
+  ShardedCounter m_send_time_us;
+  std::array<ShardedCounter, s_bin_edges_us.size() + 1> m_histogram;
+  /// Written only when a send is slower than every other in the interval, so the line is rarely contended
+  alignas(ShardedCounter::s_cache_line_size) std::atomic<uint64_t> m_max_send_time_us{ 0 }; // NOLINT(build/unsigned)
+};
+} // namespace listrev
+} // namespace dunedaq
+
+#endif // LISTREV_PLUGINS_SENDSTATISTICS_HPP_
@@ -0,0 +1,112 @@
+/**
+ * @file SenderCache.hpp
+ *
+ * SenderCache keeps resolved iomanager sender handles, and their send statistics, for one data type so that the
+ * connection lookup is done once per connection rather than once per message
+ *
+ * This is part of the DUNE DAQ Software Suite, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#ifndef LISTREV_PLUGINS_SENDERCACHE_HPP_
+#define LISTREV_PLUGINS_SENDERCACHE_HPP_
+
+#include "ListWrapper.hpp"
+#include "SendStatistics.hpp"
+
+#include "iomanager/IOManager.hpp"
+#include "iomanager/Sender.hpp"
+
+#include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+
+namespace dunedaq {
+namespace listrev {
+
+template<typename Datatype>
+class SenderCache
+{
+public:
+  struct Entry
+  {
+    std::string connection;
+    std::shared_ptr<iomanager::SenderConcept<Datatype>> sender;
+    SendStatistics stats;
+  };
+
+  SenderCache() = default;
+  SenderCache(const SenderCache&) = delete;
+  SenderCache& operator=(const SenderCache&) = delete;
+
+  /**
+   * @brief Resolve the sender for a connection, looking it up in the IOManager only the first time it is seen.
+   * The returned pointer stays valid until clear() is called.
+   */
+  Entry* resolve(const std::string& connection)
+  {
+    std::lock_guard<std::mutex> lk(m_mutex);
+    auto it = m_entries.find(connection);
+    if (it == m_entries.end()) {
+      auto entry = std::make_unique<Entry>();
+      entry->connection = connection;
+      entry->sender = get_iomanager()->get_sender<Datatype>(connection);
+      it = m_entries.emplace(connection, std::move(entry)).first;
+    }
+    return it->second.get();
+  }
+
+  /**
+   * @brief Send using an already-resolved entry, recording the outcome. Rethrows iomanager::TimeoutExpired.
+   */
+  static void send(Entry* entry, Datatype&& data, std::chrono::milliseconds timeout)
+  {
+    auto bytes = payload_size(data);
+    auto start = std::chrono::steady_clock::now();
+    try {
+      entry->sender->send(std::move(data), timeout);
+    } catch (const iomanager::TimeoutExpired&) {
+      entry->stats.record_timeout(std::chrono::steady_clock::now() - start);
+      throw;
+    }
+    entry->stats.record_send(bytes, std::chrono::steady_clock::now() - start);
+  }
+
+  /**
+   * @brief Send to a connection known only at run time (e.g. a request's destination)
+   */
+  void send(const std::string& connection, Datatype&& data, std::chrono::milliseconds timeout)
+  {
+    send(resolve(connection), std::move(data), timeout);
+  }
+
+  /**
+   * @brief Call func(connection, stats) for every resolved connection
+   */
+  template<typename Func>
+  void for_each(Func&& func)
+  {
+    std::lock_guard<std::mutex> lk(m_mutex);
+    for (auto& [connection, entry] : m_entries) {
+      func(connection, entry->stats);
+    }
+  }
+
+  void clear()
+  {
+    std::lock_guard<std::mutex> lk(m_mutex);
+    m_entries.clear();
+  }
+
+private:
+  std::map<std::string, std::unique_ptr<Entry>> m_entries;
+  mutable std::mutex m_mutex;
+};
+} // namespace listrev
+} // namespace dunedaq
+
+#endif // LISTREV_PLUGINS_SENDERCACHE_HPP_
@@ -0,0 +1,102 @@
+/**
+ * @file ShardedCounter.hpp
+ *
+ * ShardedCounter is a monotonic event counter that spreads increments over cache-line-sized shards, one per thread,
+ * so that callbacks running on different threads never contend on the same cache line. Interval values for
+ * monitoring are derived from the total at publish time instead of being kept in a second counter.
+ *
+ * This is part of the DUNE DAQ Software Suite, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#ifndef LISTREV_PLUGINS_SHARDEDCOUNTER_HPP_
+#define LISTREV_PLUGINS_SHARDEDCOUNTER_HPP_
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace dunedaq {
+namespace listrev {
+
+class ShardedCounter
+{
+public:
+  struct Snapshot
+  {
+    uint64_t total;
+    uint64_t delta; ///< Increase since the previous snapshot
+  };
+
+  ShardedCounter() = default;
+  ShardedCounter(const ShardedCounter&) = delete;
+  ShardedCounter& operator=(const ShardedCounter&) = delete;
+
+  void add(uint64_t n) noexcept
+  {
+    // Each shard is written by (normally) one thread, so a relaxed add never bounces the line between cores
+    m_shards[shard_index()].value.fetch_add(n, std::memory_order_relaxed);
+  }
+  ShardedCounter& operator++() noexcept
+  {
+    add(1);
+    return *this;
+  }
+  ShardedCounter& operator+=(uint64_t n) noexcept
+  {
+    add(n);
+    return *this;
+  }
+
+  uint64_t total() const noexcept
+  {
+    uint64_t sum = 0;
+    for (auto& shard : m_shards) {
+      sum += shard.value.load(std::memory_order_relaxed);
+    }
+    return sum;
+  }
+
+  /**
+   * @brief Current total and its increase since the previous call. Must only be called from one thread at a time
+   * (the monitoring thread).
+   */
+  Snapshot snapshot() noexcept
+  {
+    auto current = total();
+    Snapshot snap{ current, current - m_last_total };
+    m_last_total = current;
+    return snap;
+  }
+
+  /**
+   * @brief Shard of the calling thread, for other per-thread structures that follow the same assignment
+   */
+  static size_t shard_index() noexcept
+  {
+    // Threads are assigned shards round-robin on first use; if there are more threads than shards some of them
+    // share one, which is still correct because the shard is atomic
+    static std::atomic<size_t> s_next_index{ 0 };
+    thread_local const size_t t_index = s_next_index.fetch_add(1, std::memory_order_relaxed) % s_num_shards;
+    return t_index;
+  }
+
+  static constexpr size_t s_cache_line_size = 64;
+  static constexpr size_t s_num_shards = 32;
+
+private:
+
+  struct alignas(s_cache_line_size) Shard
+  {
+    std::atomic<uint64_t> value{ 0 };
+  };
+
+  std::array<Shard, s_num_shards> m_shards;
+  alignas(s_cache_line_size) uint64_t m_last_total{ 0 };
+};
+} // namespace listrev
+} // namespace dunedaq
+
+#endif // LISTREV_PLUGINS_SHARDEDCOUNTER_HPP_
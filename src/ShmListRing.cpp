@@ -0,0 +1,355 @@
+/**
+ * @file ShmListRing.cpp ShmListRing implementation
+ *
+ * This is part of the DUNE DAQ Software Suite, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#include "ShmListRing.hpp"
+
+#include "CommonIssues.hpp"
+
+#include <atomic>
+#include <cctype>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <new>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+namespace {
+constexpr size_t s_alignment = 64;
+constexpr uint64_t s_magic = 0x4c52534852494e47ULL; // NOLINT(build/unsigned)
+
+// A block's state and sequence number share one word, so that a receiver can only release the block it read
+enum BlockState : uint64_t // NOLINT(build/unsigned)
+{
+  Free = 0,
+  Written = 1,  ///< Holds a payload whose descriptor is on its way to a receiver
+  Released = 2, ///< Read by its receiver, or given up by the sender
+  Padding = 3,  ///< Fills the end of the ring before a block that did not fit there
+};
+
+uint64_t // NOLINT(build/unsigned)
+make_tag(uint64_t sequence, BlockState state) // NOLINT(build/unsigned)
+{
+  return sequence << 2 | state;
+}
+
+BlockState
+state_of(uint64_t tag) // NOLINT(build/unsigned)
+{
+  return static_cast<BlockState>(tag & 3);
+}
+
+size_t
+round_up(size_t size)
+{
+  return (size + s_alignment - 1) / s_alignment * s_alignment;
+}
+
+int64_t
+steady_now_ns()
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+    .count();
+}
+
+std::string
+errno_text(const std::string& call)
+{
+  return call + " failed: " + std::strerror(errno);
+}
+} // namespace
+
+struct alignas(s_alignment) dunedaq::listrev::ShmListRing::Header
+{
+  std::atomic<uint64_t> magic;         ///< s_magic while the sender has the ring open // NOLINT(build/unsigned)
+  uint64_t capacity;                   ///< Bytes of blocks after the header // NOLINT(build/unsigned)
+  uint64_t head;                       ///< Position of the next block; sender only // NOLINT(build/unsigned)
+  uint64_t tail;                       ///< Position of the oldest block not yet reclaimed; sender only // NOLINT
+  std::atomic<uint64_t> next_sequence; ///< Read by receivers to spot descriptors of a newer ring // NOLINT
+};
+
+struct alignas(s_alignment) dunedaq::listrev::ShmListRing::BlockHeader
+{
+  std::atomic<uint64_t> tag; ///< make_tag(sequence, state) // NOLINT(build/unsigned)
+  uint64_t size;             ///< Payload bytes // NOLINT(build/unsigned)
+  uint64_t length;           ///< Bytes from this header to the next block // NOLINT(build/unsigned)
+  int64_t written_ns;        ///< steady_clock time of write(), for the lease
+};
+
+std::unique_ptr<dunedaq::listrev::ShmListRing>
+dunedaq::listrev::ShmListRing::create(const std::string& name, size_t capacity)
+{
+  capacity = round_up(capacity);
+  if (capacity < 2 * sizeof(BlockHeader)) {
+    throw ShmRingError(ERS_HERE, name, "capacity of " + std::to_string(capacity) + " bytes is too small");
+  }
+  // A ring left behind by a sender that did not exit cleanly is replaced
+  shm_unlink(name.c_str());
+  int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+  if (fd < 0) {
+    throw ShmRingError(ERS_HERE, name, errno_text("shm_open"));
+  }
+  auto mapping_size = sizeof(Header) + capacity;
+  if (ftruncate(fd, mapping_size) != 0) {
+    auto text = errno_text("ftruncate");
+    close(fd);
+    shm_unlink(name.c_str());
+    throw ShmRingError(ERS_HERE, name, text);
+  }
+  void* mapping = mmap(nullptr, mapping_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (mapping == MAP_FAILED) {
+    shm_unlink(name.c_str());
+    throw ShmRingError(ERS_HERE, name, errno_text("mmap"));
+  }
+
+  // ftruncate zero-fills the segment, so every block header starts out Free
+  auto header = new (mapping) Header();
+  header->capacity = capacity;
+  // Sequence numbers must not repeat those of an earlier sender of the same name, or stale descriptors could match
+  header->next_sequence.store(static_cast<uint64_t>(steady_now_ns()), std::memory_order_relaxed); // NOLINT
+  header->magic.store(s_magic, std::memory_order_release);
+  return std::unique_ptr<ShmListRing>(new ShmListRing(name, mapping, mapping_size, true));
+}
+
+std::unique_ptr<dunedaq::listrev::ShmListRing>
+dunedaq::listrev::ShmListRing::attach(const std::string& name)
+{
+  int fd = shm_open(name.c_str(), O_RDWR, 0);
+  if (fd < 0) {
+    throw ShmRingError(ERS_HERE, name, errno_text("shm_open"));
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0) {
+    auto text = errno_text("fstat");
+    close(fd);
+    throw ShmRingError(ERS_HERE, name, text);
+  }
+  auto mapping_size = static_cast<size_t>(st.st_size);
+  if (mapping_size < sizeof(Header)) {
+    close(fd);
+    throw ShmRingError(ERS_HERE, name, "segment is too small to be a list ring");
+  }
+  void* mapping = mmap(nullptr, mapping_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (mapping == MAP_FAILED) {
+    throw ShmRingError(ERS_HERE, name, errno_text("mmap"));
+  }
+  auto header = static_cast<Header*>(mapping);
+  if (header->magic.load(std::memory_order_acquire) != s_magic || sizeof(Header) + header->capacity != mapping_size) {
+    munmap(mapping, mapping_size);
+    throw ShmRingError(ERS_HERE, name, "segment is not a list ring");
+  }
+  return std::unique_ptr<ShmListRing>(new ShmListRing(name, mapping, mapping_size, false));
+}
+
+std::string
+dunedaq::listrev::ShmListRing::ring_name(const std::string& sender, const std::string& destination)
+{
+  std::string name = "/listrev_" + sender + "_" + destination;
+  for (size_t idx = 1; idx < name.size(); ++idx) {
+    auto c = static_cast<unsigned char>(name[idx]);
+    if (!std::isalnum(c) && c != '-' && c != '.') {
+      name[idx] = '_';
+    }
+  }
+  return name.substr(0, 250);
+}
+
+std::string
+dunedaq::listrev::ShmListRing::local_host()
+{
+  char host[256] = {};
+  if (gethostname(host, sizeof(host) - 1) != 0) {
+    return "";
+  }
+  return host;
+}
+
+dunedaq::listrev::ShmListRing::ShmListRing(std::string name, void* mapping, size_t mapping_size, bool owner)
+  : m_name(std::move(name))
+  , m_mapping(mapping)
+  , m_mapping_size(mapping_size)
+  , m_owner(owner)
+  , m_header(static_cast<Header*>(mapping))
+  , m_data(static_cast<uint8_t*>(mapping) + sizeof(Header)) // NOLINT(build/unsigned)
+{
+}
+
+dunedaq::listrev::ShmListRing::~ShmListRing()
+{
+  if (m_owner) {
+    // Receivers that still map the segment after it is unlinked see that it is closed, and attach again
+    m_header->magic.store(0, std::memory_order_release);
+  }
+  munmap(m_mapping, m_mapping_size);
+  if (m_owner) {
+    shm_unlink(m_name.c_str());
+  }
+}
+
+size_t
+dunedaq::listrev::ShmListRing::capacity() const
+{
+  return m_header->capacity;
+}
+
+bool
+dunedaq::listrev::ShmListRing::superseded(const IntList& descriptor) const
+{
+  // A recreated ring starts its sequence numbers after those of every earlier ring of the same name, even if the
+  // earlier sender could not close its ring
+  return m_header->magic.load(std::memory_order_acquire) != s_magic ||
+         descriptor.shm_sequence > m_header->next_sequence.load(std::memory_order_acquire);
+}
+
+dunedaq::listrev::ShmListRing::BlockHeader*
+dunedaq::listrev::ShmListRing::block_at(uint64_t offset) const // NOLINT(build/unsigned)
+{
+  if (offset % s_alignment != 0 || offset + sizeof(BlockHeader) > m_header->capacity) {
+    return nullptr;
+  }
+  return reinterpret_cast<BlockHeader*>(m_data + offset);
+}
+
+void
+dunedaq::listrev::ShmListRing::reclaim(std::chrono::milliseconds lease)
+{
+  auto now_ns = steady_now_ns();
+  auto lease_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(lease).count();
+  while (m_header->tail < m_header->head) {
+    auto block = block_at(m_header->tail % m_header->capacity);
+    auto tag = block->tag.load(std::memory_order_acquire);
+    if (state_of(tag) == Written) {
+      if (lease.count() == 0 || now_ns - block->written_ns < lease_ns) {
+        break;
+      }
+      // The descriptor was lost, or its receiver is very late; if it is still copying, its copy will be rejected.
+      // Failing here means the receiver released the block in the meantime.
+      block->tag.compare_exchange_strong(tag, make_tag(0, Free), std::memory_order_acq_rel);
+    }
+    block->tag.store(make_tag(0, Free), std::memory_order_relaxed);
+    // Orders the state change before the writes that will reuse the block's bytes
+    std::atomic_thread_fence(std::memory_order_release);
+    m_header->tail += block->length;
+  }
+}
+
+bool
+dunedaq::listrev::ShmListRing::write(IntList& list, std::chrono::milliseconds lease)
+{
+  const uint8_t* payload = list.encoded.data(); // NOLINT(build/unsigned)
+  size_t size = list.encoded.size();
+  if (list.encoding == 0) {
+    payload = reinterpret_cast<const uint8_t*>(list.list.data()); // NOLINT(build/unsigned)
+    size = list.list.size() * sizeof(int);
+  }
+  auto length = round_up(sizeof(BlockHeader) + size);
+
+  std::lock_guard<std::mutex> lk(m_write_mutex);
+  auto capacity = m_header->capacity;
+  if (length > capacity) {
+    return false;
+  }
+  reclaim(lease);
+  if (m_header->tail == m_header->head) {
+    m_header->tail = 0;
+    m_header->head = 0;
+  }
+  auto offset = m_header->head % capacity;
+  auto padding = offset + length > capacity ? capacity - offset : 0;
+  if (m_header->head - m_header->tail + padding + length > capacity) {
+    return false;
+  }
+  if (padding > 0) {
+    auto block = block_at(offset);
+    block->length = padding;
+    block->tag.store(make_tag(0, Padding), std::memory_order_release);
+    m_header->head += padding;
+    offset = 0;
+  }
+
+  auto block = block_at(offset);
+  auto sequence = m_header->next_sequence.load(std::memory_order_relaxed) + 1;
+  block->size = size;
+  block->length = length;
+  block->written_ns = steady_now_ns();
+  std::memcpy(m_data + offset + sizeof(BlockHeader), payload, size);
+  block->tag.store(make_tag(sequence, Written), std::memory_order_release);
+  // Published after the block, so that a receiver never takes a descriptor of this ring for one of a newer ring
+  m_header->next_sequence.store(sequence, std::memory_order_release);
+  m_header->head += length;
+
+  list.shm_ring = m_name;
+  list.shm_offset = offset;
+  list.shm_sequence = sequence;
+  std::vector<int>().swap(list.list);
+  std::vector<uint8_t>().swap(list.encoded); // NOLINT(build/unsigned)
+  return true;
+}
+
+void
+dunedaq::listrev::ShmListRing::release(const IntList& descriptor)
+{
+  auto block = block_at(descriptor.shm_offset);
+  if (block == nullptr) {
+    return;
+  }
+  auto expected = make_tag(descriptor.shm_sequence, Written);
+  block->tag.compare_exchange_strong(
+    expected, make_tag(descriptor.shm_sequence, Released), std::memory_order_acq_rel);
+}
+
+void
+dunedaq::listrev::ShmListRing::reset()
+{
+  std::lock_guard<std::mutex> lk(m_write_mutex);
+  m_header->head = 0;
+  m_header->tail = 0;
+}
+
+bool
+dunedaq::listrev::ShmListRing::read(const IntList& descriptor, IntList& list)
+{
+  auto block = block_at(descriptor.shm_offset);
+  auto written = make_tag(descriptor.shm_sequence, Written);
+  if (block == nullptr || block->tag.load(std::memory_order_acquire) != written) {
+    return false;
+  }
+  auto size = block->size;
+  if (descriptor.shm_offset + sizeof(BlockHeader) + size > capacity() ||
+      (descriptor.encoding == 0 && size % sizeof(int) != 0)) {
+    return false;
+  }
+
+  list.list_id = descriptor.list_id;
+  list.generator_id = descriptor.generator_id;
+  list.trace_id = descriptor.trace_id;
+  list.trace_ns = descriptor.trace_ns;
+  list.encoding = descriptor.encoding;
+  list.shm_ring.clear();
+  list.shm_offset = 0;
+  list.shm_sequence = 0;
+  const uint8_t* payload = m_data + descriptor.shm_offset + sizeof(BlockHeader); // NOLINT(build/unsigned)
+  if (descriptor.encoding == 0) {
+    list.encoded.clear();
+    list.list.resize(size / sizeof(int));
+    std::memcpy(list.list.data(), payload, size);
+  } else {
+    list.list.clear();
+    list.encoded.assign(payload, payload + size);
+  }
+
+  // The copy is good only if the sender did not reclaim the block while it was made
+  std::atomic_thread_fence(std::memory_order_acquire);
+  return block->tag.compare_exchange_strong(
+    written, make_tag(descriptor.shm_sequence, Released), std::memory_order_acq_rel);
+}
@@ -0,0 +1,118 @@
+/**
+ * @file ShmListRing.hpp
+ *
+ * ShmListRing passes list payloads between processes on the same host through a POSIX shared-memory segment, so
+ * that only a small descriptor has to go through the iomanager connection. The sender owns the ring: write() copies
+ * the elements (or encoded bytes) of an IntList into the next free block and replaces them in the IntList by the
+ * ring name, block offset and sequence number. The receiver attaches to the ring by that name, and read() copies
+ * the payload back out and releases the block. Blocks are reclaimed in ring order by the sender once released; a
+ * block whose descriptor was lost is reclaimed after the lease given to write(). A receiver that reads a block
+ * while it is being reclaimed sees its sequence number change and rejects the copy.
+ *
+ * One process creates and writes a ring, from any number of threads; any number of processes, and threads, may read
+ * from it concurrently.
+ *
+ * This is part of the DUNE DAQ Software Suite, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#ifndef LISTREV_PLUGINS_SHMLISTRING_HPP_
+#define LISTREV_PLUGINS_SHMLISTRING_HPP_
+
+#include "ListWrapper.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace dunedaq {
+namespace listrev {
+
+class ShmListRing
+{
+public:
+  /**
+   * @brief Create (or recreate) the ring called name with room for capacity bytes of blocks, and unlink it when
+   * destroyed
+   * @throws ShmRingError if the segment cannot be created or mapped
+   */
+  static std::unique_ptr<ShmListRing> create(const std::string& name, size_t capacity);
+
+  /**
+   * @brief Map the ring called name, created by another process on this host
+   * @throws ShmRingError if there is no such ring or it is not a ShmListRing
+   */
+  static std::unique_ptr<ShmListRing> attach(const std::string& name);
+
+  /**
+   * @brief Name for the ring of a sender and destination, usable with shm_open
+   */
+  static std::string ring_name(const std::string& sender, const std::string& destination);
+
+  /**
+   * @brief Name of this host, as put in RequestList::host by a requestor that can read from a ring
+   */
+  static std::string local_host();
+
+  ShmListRing(const ShmListRing&) = delete;
+  ShmListRing& operator=(const ShmListRing&) = delete;
+  ~ShmListRing();
+
+  const std::string& name() const { return m_name; }
+  size_t capacity() const;
+
+  /**
+   * @brief Move the payload of list into the ring, reclaiming released blocks and blocks older than lease first
+   * @return false, leaving list unchanged, if the ring has no room for it
+   */
+  bool write(IntList& list, std::chrono::milliseconds lease);
+
+  /**
+   * @brief Release the block of a list written by write() whose descriptor will never reach a receiver
+   */
+  void release(const IntList& descriptor);
+
+  /**
+   * @brief Forget all blocks; only while no receiver is reading
+   */
+  void reset();
+
+  /**
+   * @brief Whether the sender has closed this ring, or replaced it with a new one of the same name that the
+   * descriptor belongs to; the ring must then be attached again
+   */
+  bool superseded(const IntList& descriptor) const;
+
+  /**
+   * @brief Copy the payload a descriptor refers to into list, with the descriptor's other fields, and release
+   * its block
+   * @return false if the descriptor does not refer to a live block of this ring
+   */
+  bool read(const IntList& descriptor, IntList& list);
+
+private:
+  struct Header;
+  struct BlockHeader;
+
+  ShmListRing(std::string name, void* mapping, size_t mapping_size, bool owner);
+
+  BlockHeader* block_at(uint64_t offset) const; // NOLINT(build/unsigned)
+  void reclaim(std::chrono::milliseconds lease);
+
+  std::string m_name;
+  void* m_mapping;
+  size_t m_mapping_size;
+  bool m_owner;
+  Header* m_header;
+  uint8_t* m_data; // NOLINT(build/unsigned)
+  std::mutex m_write_mutex;
+};
+
+} // namespace listrev
+} // namespace dunedaq
+
+#endif // LISTREV_PLUGINS_SHMLISTRING_HPP_
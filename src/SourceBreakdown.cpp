@@ -0,0 +1,78 @@
+/**
+ * @file SourceBreakdown.cpp SourceBreakdown implementations
+ *
+ * This is part of the DUNE DAQ Software Suite, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#include "SourceBreakdown.hpp"
+
+dunedaq::listrev::SourceBreakdown::Counts&
+dunedaq::listrev::SourceBreakdown::counts_for(int source_id)
+{
+  if (source_id >= 0 && source_id < s_direct_sources) {
+    auto& slot = m_direct[source_id];
+    auto counts = slot.load(std::memory_order_acquire);
+    if (counts == nullptr) {
+      // Two threads seeing a new source at once both allocate; the one that loses the exchange frees its copy
+      auto fresh = std::make_unique<Counts>();
+      if (slot.compare_exchange_strong(counts, fresh.get(), std::memory_order_acq_rel)) {
+        counts = fresh.release();
+      }
+    }
+    return *counts;
+  }
+
+  std::lock_guard<std::mutex> lk(m_other_mutex);
+  auto& counts = m_other[source_id];
+  if (counts == nullptr) {
+    counts = std::make_unique<Counts>();
+  }
+  return *counts;
+}
+
+void
+dunedaq::listrev::SourceBreakdown::record(int source_id, uint64_t lists, uint64_t elements, uint64_t bytes)
+{
+  auto& counts = counts_for(source_id);
+  counts.lists += lists;
+  counts.elements += elements;
+  counts.bytes += bytes;
+}
+
+void
+dunedaq::listrev::SourceBreakdown::generate_opmon_data(const std::function<void(int, opmon::ListSourceInfo&&)>& func)
+{
+  std::map<int, Counts*> sources;
+  for (int id = 0; id < s_direct_sources; ++id) {
+    if (auto counts = m_direct[id].load(std::memory_order_acquire)) {
+      sources[id] = counts;
+    }
+  }
+  {
+    // Entries are never removed while the module runs, so the pointers stay valid after the lock is released
+    std::lock_guard<std::mutex> lk(m_other_mutex);
+    for (auto& [id, counts] : m_other) {
+      sources[id] = counts.get();
+    }
+  }
+
+  for (auto& [id, counts] : sources) {
+    opmon::ListSourceInfo info;
+    info.set_lists(counts->lists.snapshot().delta);
+    info.set_elements(counts->elements.snapshot().delta);
+    info.set_bytes(counts->bytes.snapshot().delta);
+    func(id, std::move(info));
+  }
+}
+
+void
+dunedaq::listrev::SourceBreakdown::clear()
+{
+  for (auto& slot : m_direct) {
+    delete slot.exchange(nullptr);
+  }
+  std::lock_guard<std::mutex> lk(m_other_mutex);
+  m_other.clear();
+}
@@ -0,0 +1,72 @@
+/**
+ * @file SourceBreakdown.hpp
+ *
+ * SourceBreakdown accumulates list, element and byte counts split by the id of the module that produced them. Ids
+ * below s_direct_sources, which covers the generator and reverser ids of any real configuration, index their counts
+ * directly and are recorded without a lock, so that validation workers do not contend; other ids fall back to a
+ * map under a mutex.
+ *
+ * This is part of the DUNE DAQ Software Suite, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#ifndef LISTREV_PLUGINS_SOURCEBREAKDOWN_HPP_
+#define LISTREV_PLUGINS_SOURCEBREAKDOWN_HPP_
+
+#include "ShardedCounter.hpp"
+
+#include "listrev/opmon/list_rev_info.pb.h"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+
+namespace dunedaq {
+namespace listrev {
+
+class SourceBreakdown
+{
+public:
+  SourceBreakdown() = default;
+  SourceBreakdown(const SourceBreakdown&) = delete;
+  SourceBreakdown& operator=(const SourceBreakdown&) = delete;
+  ~SourceBreakdown() { clear(); }
+
+  void record(int source_id, uint64_t lists, uint64_t elements, uint64_t bytes); // NOLINT(build/unsigned)
+
+  /**
+   * @brief Call func(source_id, info) with the counts accumulated for each source since the previous call. Sources
+   * stay known once seen, so a silent source is reported with zero counts. Must only be called from one thread at a
+   * time (the monitoring thread).
+   */
+  void generate_opmon_data(const std::function<void(int, opmon::ListSourceInfo&&)>& func);
+
+  /**
+   * @brief Forget all sources; not safe against concurrent record() calls
+   */
+  void clear();
+
+  static constexpr int s_direct_sources = 256;
+
+private:
+  struct Counts
+  {
+    ShardedCounter lists;
+    ShardedCounter elements;
+    ShardedCounter bytes;
+  };
+  Counts& counts_for(int source_id);
+
+  std::array<std::atomic<Counts*>, s_direct_sources> m_direct{}; ///< Allocated on first use
+  std::map<int, std::unique_ptr<Counts>> m_other;                ///< Ids outside the direct range
+  std::mutex m_other_mutex;
+};
+} // namespace listrev
+} // namespace dunedaq
+
+#endif // LISTREV_PLUGINS_SOURCEBREAKDOWN_HPP_
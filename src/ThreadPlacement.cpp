@@ -0,0 +1,159 @@
+/**
+ * @file ThreadPlacement.cpp ThreadPlacement implementation
+ *
+ * This is part of the DUNE DAQ Software Suite, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#include "ThreadPlacement.hpp"
+
+#include "CommonIssues.hpp"
+
+#include <pthread.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <sstream>
+
+namespace {
+/// From linux/mempolicy.h: allocate on the node of the CPU that touches the memory
+constexpr int s_mpol_local = 4;
+
+// The (placement, generation) last applied to this thread
+thread_local const void* t_placement = nullptr;
+thread_local uint64_t t_generation = 0; // NOLINT(build/unsigned)
+} // namespace
+
+std::vector<int>
+dunedaq::listrev::parse_cpu_list(const std::string& cpus)
+{
+  std::vector<int> result;
+  std::istringstream in(cpus);
+  std::string range;
+  while (std::getline(in, range, ',')) {
+    if (range.empty()) {
+      continue;
+    }
+    int first = 0;
+    int last = 0;
+    char dash = 0;
+    std::istringstream range_in(range);
+    range_in >> first;
+    if (range_in && !range_in.eof() && range_in.peek() == '-') {
+      range_in >> dash >> last;
+    } else {
+      last = first;
+    }
+    if (!range_in || !range_in.eof() || first < 0 || last < first || last >= CPU_SETSIZE) {
+      throw ThreadPlacementError(ERS_HERE, "invalid CPU range \"" + range + "\" in \"" + cpus + "\"");
+    }
+    for (int cpu = first; cpu <= last; ++cpu) {
+      result.push_back(cpu);
+    }
+  }
+  return result;
+}
+
+std::string
+dunedaq::listrev::format_cpu_list(const std::vector<int>& cpus)
+{
+  std::ostringstream out;
+  for (size_t idx = 0; idx < cpus.size();) {
+    auto end = idx;
+    while (end + 1 < cpus.size() && cpus[end + 1] == cpus[end] + 1) {
+      ++end;
+    }
+    out << (idx > 0 ? "," : "") << cpus[idx];
+    if (end > idx) {
+      out << "-" << cpus[end];
+    }
+    idx = end + 1;
+  }
+  return out.str();
+}
+
+std::string
+dunedaq::listrev::describe_current_thread()
+{
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  std::vector<int> allowed;
+  if (pthread_getaffinity_np(pthread_self(), sizeof(set), &set) == 0) {
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+      if (CPU_ISSET(cpu, &set)) {
+        allowed.push_back(cpu);
+      }
+    }
+  }
+
+  unsigned cpu = 0;
+  unsigned node = 0;
+  std::ostringstream out;
+  out << "cpus " << format_cpu_list(allowed);
+  if (syscall(SYS_getcpu, &cpu, &node, nullptr) == 0) {
+    out << ", running on cpu " << cpu << " (NUMA node " << node << ")";
+  }
+  return out.str();
+}
+
+void
+dunedaq::listrev::ThreadPlacement::configure(const std::string& cpus, bool local_memory)
+{
+  m_cpus = parse_cpu_list(cpus);
+  m_local_memory = local_memory;
+  ++m_generation;
+}
+
+bool
+dunedaq::listrev::ThreadPlacement::place()
+{
+  auto generation = m_generation.load(std::memory_order_relaxed);
+  if (!active() || (t_placement == this && t_generation == generation)) {
+    return false;
+  }
+  t_placement = this;
+  t_generation = generation;
+
+  if (!m_cpus.empty()) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (auto cpu : m_cpus) {
+      CPU_SET(cpu, &set);
+    }
+    auto rc = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    if (rc != 0) {
+      throw ThreadPlacementError(ERS_HERE, "cannot pin to cpus " + format_cpu_list(m_cpus) + ": " + strerror(rc));
+    }
+    // Move onto one of the new CPUs before allocating anything
+    sched_yield();
+  }
+  if (m_local_memory && syscall(SYS_set_mempolicy, s_mpol_local, nullptr, 0) != 0) {
+    throw ThreadPlacementError(ERS_HERE, std::string("cannot set the local memory policy: ") + strerror(errno));
+  }
+  return true;
+}
+
+void
+dunedaq::listrev::ThreadPlacement::place(const std::string& module_name, const std::string& role)
+{
+  try {
+    if (place()) {
+      ers::info(ProgressUpdate(ERS_HERE, module_name, role + " thread placed on " + describe_current_thread()));
+    }
+  } catch (const ThreadPlacementError& excpt) {
+    ers::warning(excpt);
+  }
+}
+
+std::string
+dunedaq::listrev::ThreadPlacement::describe() const
+{
+  std::ostringstream out;
+  out << (m_cpus.empty() ? "any cpu" : "cpus " + format_cpu_list(m_cpus))
+      << (m_local_memory ? ", local memory" : "");
+  return out.str();
+}
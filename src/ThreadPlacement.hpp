@@ -0,0 +1,76 @@
+/**
+ * @file ThreadPlacement.hpp
+ *
+ * ThreadPlacement pins the threads that run a module's code to a configured set of CPUs and, optionally, makes
+ * them allocate memory on their local NUMA node, so that list buffers are created next to the core that fills
+ * them. Worker threads owned by a module are placed once when they start. IOManager callback threads are created
+ * by the IOManager, so they are placed by the first callback they run, and again after each reconfiguration.
+ *
+ * Placement uses the Linux affinity and memory-policy system calls directly, without a libnuma dependency.
+ *
+ * This is part of the DUNE DAQ Software Suite, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#ifndef LISTREV_PLUGINS_THREADPLACEMENT_HPP_
+#define LISTREV_PLUGINS_THREADPLACEMENT_HPP_
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace dunedaq {
+namespace listrev {
+
+/**
+ * @brief Parse a CPU list such as "0-3,8,10-11"; an empty string gives an empty set
+ * @throws ThreadPlacementError for malformed input
+ */
+std::vector<int>
+parse_cpu_list(const std::string& cpus);
+std::string
+format_cpu_list(const std::vector<int>& cpus);
+
+/**
+ * @brief CPUs the calling thread may run on, the CPU it is running on and that CPU's NUMA node
+ */
+std::string
+describe_current_thread();
+
+class ThreadPlacement
+{
+public:
+  ThreadPlacement() = default;
+
+  /**
+   * @brief Set the placement applied by place(); an empty cpu list leaves the affinity alone
+   */
+  void configure(const std::string& cpus, bool local_memory);
+
+  /**
+   * @brief Apply the placement to the calling thread if it has not been applied there since the last configure()
+   * @return Whether the placement was applied now
+   * @throws ThreadPlacementError if the system refuses it
+   */
+  bool place();
+
+  /**
+   * @brief place(), reporting the resulting placement of the thread, or the failure as a warning
+   */
+  void place(const std::string& module_name, const std::string& role);
+
+  bool active() const { return !m_cpus.empty() || m_local_memory; }
+  std::string describe() const;
+
+private:
+  std::vector<int> m_cpus;
+  bool m_local_memory{ false };
+  std::atomic<uint64_t> m_generation{ 1 }; // NOLINT(build/unsigned)
+};
+
+} // namespace listrev
+} // namespace dunedaq
+
+#endif // LISTREV_PLUGINS_THREADPLACEMENT_HPP_
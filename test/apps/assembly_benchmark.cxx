@@ -0,0 +1,126 @@
+/**
+ * @file assembly_benchmark.cxx
+ *
+ * Measure the cost per list of assembling list sets in ListReverser as the number of generators per reverser grows.
+ * Lists of a set arrive in a random generator order. Each arrival is checked for a duplicate, stored and checked
+ * for completion, first by scanning the lists already in the set as ListReverser used to, then with the generator
+ * bitmap and per-generator slots of PendingList. The scan grows with the number of generators; the bitmap should not.
+ * The lists are empty, so that copying their elements does not hide the assembly cost.
+ *
+ * This is part of the DUNE DAQ Software Suite, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#include "PendingListTable.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using namespace dunedaq::listrev;
+
+namespace {
+
+constexpr size_t s_in_flight = 16;
+
+/**
+ * @brief Arrival order of the generator ids for each list set
+ */
+std::vector<std::vector<int>>
+make_orders(size_t generators, size_t sets)
+{
+  std::mt19937 rng(generators);
+  std::vector<int> ids(generators);
+  for (size_t gen = 0; gen < generators; ++gen) {
+    ids[gen] = static_cast<int>(gen);
+  }
+  std::vector<std::vector<int>> orders;
+  for (size_t set = 0; set < sets; ++set) {
+    std::shuffle(ids.begin(), ids.end(), rng);
+    orders.push_back(ids);
+  }
+  return orders;
+}
+
+/**
+ * @brief Feed every list set its lists, keeping s_in_flight sets in a table with slots preallocated entries per set;
+ * returns ns per list
+ */
+template<typename Add>
+double
+run(size_t slots, const std::vector<std::vector<int>>& orders, Add add)
+{
+  PendingListTable table(s_in_flight, slots);
+  size_t completed = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (size_t step = 0; step < orders.size() + s_in_flight; ++step) {
+    if (step < orders.size()) {
+      table.insert(static_cast<int>(step));
+    }
+    if (step >= s_in_flight) {
+      int id = static_cast<int>(step - s_in_flight);
+      for (auto gen : orders[id]) {
+        auto pending = table.find(id);
+        if (add(*pending, IntList(id, gen, std::vector<int>()))) {
+          ++completed;
+          table.erase(id);
+        }
+      }
+    }
+  }
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  if (completed != orders.size()) {
+    std::cerr << "expected " << orders.size() << " complete list sets, got " << completed << std::endl;
+  }
+  return std::chrono::duration<double, std::nano>(elapsed).count() / (orders.size() * orders.front().size());
+}
+
+} // namespace
+
+int
+main(int argc, char** argv)
+{
+  size_t total_lists = 2000000;
+  if (argc > 1) {
+    total_lists = std::strtoul(argv[1], nullptr, 10);
+  }
+
+  std::cout << std::setw(12) << "generators" << std::setw(14) << "scan ns/list" << std::setw(16) << "bitmap ns/list"
+            << std::endl;
+  for (size_t generators : { 4, 16, 64, 256 }) {
+    auto orders = make_orders(generators, std::max<size_t>(total_lists / generators, 1));
+
+    // Duplicate check by scanning the set, lists appended in arrival order, completion by count of lists
+    auto scan = run(0, orders, [&](PendingList& pending, const IntList& list) {
+      pending.list.lists.reserve(generators);
+      if (std::any_of(pending.list.lists.begin(), pending.list.lists.end(), [&](const ReversedList::Data& data) {
+            return data.original.generator_id == list.generator_id;
+          })) {
+        return false;
+      }
+      auto& data = pending.list.lists.emplace_back();
+      data.original = list;
+      data.reversed = list;
+      return pending.list.lists.size() >= generators;
+    });
+
+    auto bitmap = run(generators, orders, [&](PendingList& pending, const IntList& list) {
+      if (pending.has_list_from(list.generator_id)) {
+        return false;
+      }
+      auto& data = pending.add_list_from(list.generator_id, list.generator_id);
+      data.original = list;
+      data.reversed = list;
+      return pending.received_lists >= generators;
+    });
+
+    std::cout << std::setw(12) << generators << std::fixed << std::setprecision(1) << std::setw(14) << scan
+              << std::setw(16) << bitmap << std::endl;
+  }
+  return 0;
+}
@@ -0,0 +1,133 @@
+/**
+ * @file encoding_benchmark.cxx
+ *
+ * Measure the list encodings of ListEncoding.hpp on lists of every ListMode: the compression ratio against the
+ * plain four bytes per element, and the encode and decode time per element. Each encoding also has to reproduce
+ * the original list.
+ *
+ * This is part of the DUNE DAQ Software Suite, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#include "ListEncoding.hpp"
+#include "ListKernels.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace dunedaq::listrev;
+
+namespace {
+
+const char*
+mode_name(ListMode mode)
+{
+  switch (mode) {
+    case ListMode::Random:
+      return "random";
+    case ListMode::Ascending:
+      return "ascending";
+    case ListMode::Evens:
+      return "evens";
+    case ListMode::Odds:
+      return "odds";
+    case ListMode::Descending:
+      return "descending";
+  }
+  return "unknown";
+}
+
+struct Result
+{
+  double ratio;
+  double encode_ns;
+  double decode_ns;
+  ListEncoding used;
+  bool correct;
+};
+
+Result
+run(const std::vector<std::vector<int>>& lists, ListEncoding encoding, size_t repeats)
+{
+  std::vector<std::vector<uint8_t>> encoded(lists.size()); // NOLINT(build/unsigned)
+  std::vector<ListEncoding> used(lists.size());
+  size_t elements = 0;
+  for (auto& list : lists) {
+    elements += list.size();
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  for (size_t rep = 0; rep < repeats; ++rep) {
+    for (size_t idx = 0; idx < lists.size(); ++idx) {
+      used[idx] = encode_values(lists[idx], encoding, encoded[idx]);
+    }
+  }
+  auto encode_time = std::chrono::steady_clock::now() - start;
+
+  std::vector<int> values;
+  bool correct = true;
+  start = std::chrono::steady_clock::now();
+  for (size_t rep = 0; rep < repeats; ++rep) {
+    for (size_t idx = 0; idx < lists.size(); ++idx) {
+      decode_values(encoded[idx].data(), encoded[idx].size(), used[idx], values);
+      if (rep == 0) {
+        correct &= values == lists[idx];
+      }
+    }
+  }
+  auto decode_time = std::chrono::steady_clock::now() - start;
+
+  size_t bytes = 0;
+  for (auto& data : encoded) {
+    bytes += data.size();
+  }
+  double total = static_cast<double>(elements) * repeats;
+  return { static_cast<double>(elements * sizeof(int)) / bytes,
+           std::chrono::duration<double, std::nano>(encode_time).count() / total,
+           std::chrono::duration<double, std::nano>(decode_time).count() / total,
+           used.front(),
+           correct };
+}
+
+} // namespace
+
+int
+main(int argc, char** argv)
+{
+  size_t list_size = 1000;
+  size_t num_lists = 1000;
+  size_t repeats = 20;
+  if (argc > 1) {
+    list_size = std::strtoul(argv[1], nullptr, 10);
+  }
+  if (argc > 2) {
+    repeats = std::strtoul(argv[2], nullptr, 10);
+  }
+
+  std::cout << std::setw(12) << "mode" << std::setw(8) << "request" << std::setw(8) << "used" << std::setw(10)
+            << "ratio" << std::setw(14) << "encode ns/el" << std::setw(14) << "decode ns/el" << std::endl;
+  bool all_correct = true;
+  for (size_t mode_idx = 0; mode_idx <= static_cast<size_t>(ListMode::MAX); ++mode_idx) {
+    auto mode = static_cast<ListMode>(mode_idx);
+    std::vector<std::vector<int>> lists(num_lists, std::vector<int>(list_size));
+    for (size_t id = 0; id < num_lists; ++id) {
+      fill_list(mode, static_cast<int>(id + 1), lists[id]);
+    }
+
+    for (auto encoding :
+         { ListEncoding::Stride, ListEncoding::DeltaVarint, ListEncoding::FrameOfReference, ListEncoding::Auto }) {
+      auto result = run(lists, encoding, repeats);
+      all_correct &= result.correct;
+      std::cout << std::setw(12) << mode_name(mode) << std::setw(8) << list_encoding_name(encoding) << std::setw(8)
+                << list_encoding_name(result.used) << std::setw(10) << std::fixed << std::setprecision(1)
+                << result.ratio << std::setw(14) << std::setprecision(2) << result.encode_ns << std::setw(14)
+                << result.decode_ns << (result.correct ? "" : "  MISMATCH") << std::endl;
+    }
+  }
+  return all_correct ? 0 : 1;
+}
@@ -0,0 +1,112 @@
+/**
+ * @file parallel_kernels_benchmark.cxx
+ *
+ * Measure the speedup of the block-parallel fill, reverse and compare kernels of ListKernels.hpp over their
+ * single-threaded versions, for a range of list sizes and worker counts. The parallel results also have to
+ * validate: every reversal is checked, in parallel, against its original.
+ *
+ * This is part of the DUNE DAQ Software Suite, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#include "ListKernels.hpp"
+#include "ListWorkPool.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace dunedaq::listrev;
+
+namespace {
+
+struct Times
+{
+  double fill_us{ 0 };
+  double reverse_us{ 0 };
+  double compare_us{ 0 };
+  bool correct{ true };
+};
+
+double
+elapsed_us(std::chrono::steady_clock::time_point start)
+{
+  return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+}
+
+/**
+ * @brief Best of repeats timings of each kernel on an ascending list of size elements
+ */
+Times
+run(size_t size, const ParallelPolicy& parallel, size_t repeats)
+{
+  Times best{ 1e30, 1e30, 1e30, true };
+  IntList list(1, 0, std::vector<int>(size));
+  ReversedList::Data data;
+  for (size_t rep = 0; rep < repeats; ++rep) {
+    auto start = std::chrono::steady_clock::now();
+    fill_list(ListMode::Ascending, 1, list.list, parallel);
+    best.fill_us = std::min(best.fill_us, elapsed_us(start));
+
+    start = std::chrono::steady_clock::now();
+    reverse_list(list, 0, data, parallel);
+    best.reverse_us = std::min(best.reverse_us, elapsed_us(start));
+
+    start = std::chrono::steady_clock::now();
+    best.correct &= is_reversal(data.original, data.reversed, parallel);
+    best.compare_us = std::min(best.compare_us, elapsed_us(start));
+  }
+  return best;
+}
+
+} // namespace
+
+int
+main(int argc, char** argv)
+{
+  size_t max_threads = std::max(1u, std::thread::hardware_concurrency());
+  size_t repeats = 5;
+  if (argc > 1) {
+    max_threads = std::strtoul(argv[1], nullptr, 10);
+  }
+  if (argc > 2) {
+    repeats = std::strtoul(argv[2], nullptr, 10);
+  }
+
+  std::vector<size_t> thread_counts;
+  for (size_t threads = 1; threads < max_threads; threads *= 2) {
+    thread_counts.push_back(threads);
+  }
+  thread_counts.push_back(max_threads);
+
+  std::cout << "Speedup over one thread; the calling thread works alongside the pool's workers" << std::endl;
+  std::cout << std::setw(10) << "elements" << std::setw(9) << "threads" << std::setw(12) << "fill us" << std::setw(9)
+            << "x" << std::setw(12) << "reverse us" << std::setw(9) << "x" << std::setw(12) << "compare us"
+            << std::setw(9) << "x" << std::endl;
+
+  bool all_correct = true;
+  for (size_t size : { 1UL << 14, 1UL << 16, 1UL << 18, 1UL << 20, 1UL << 22, 1UL << 24 }) {
+    auto serial = run(size, ParallelPolicy(), repeats);
+    all_correct &= serial.correct;
+    for (auto threads : thread_counts) {
+      // A pool per thread count, since a pool never shrinks; threads - 1 workers plus the caller
+      std::unique_ptr<ListWorkPool> pool(new ListWorkPool());
+      pool->reserve(threads - 1);
+      Times result = threads > 1 ? run(size, ParallelPolicy{ pool.get(), 1 }, repeats) : serial;
+      all_correct &= result.correct;
+      std::cout << std::setw(10) << size << std::setw(9) << threads << std::fixed << std::setprecision(1)
+                << std::setw(12) << result.fill_us << std::setw(9) << std::setprecision(2)
+                << serial.fill_us / result.fill_us << std::setprecision(1) << std::setw(12) << result.reverse_us
+                << std::setw(9) << std::setprecision(2) << serial.reverse_us / result.reverse_us
+                << std::setprecision(1) << std::setw(12) << result.compare_us << std::setw(9) << std::setprecision(2)
+                << serial.compare_us / result.compare_us << (result.correct ? "" : "  MISMATCH") << std::endl;
+    }
+  }
+  return all_correct ? 0 : 1;
+}
@@ -0,0 +1,131 @@
+/**
+ * @file pending_table_benchmark.cxx
+ *
+ * Compare PendingListTable against the std::map<int, PendingList> it replaced in ListReverser, using the
+ * ListReverser access pattern: a list set is created by a request, receives one list per generator, and is erased
+ * once complete. The number of list sets in flight is held constant for each measurement.
+ *
+ * This is part of the DUNE DAQ Software Suite, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#include "PendingListTable.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+using namespace dunedaq::listrev;
+
+namespace {
+
+constexpr size_t s_num_generators = 3;
+
+IntList
+make_list(int list_id, int generator_id)
+{
+  return IntList(list_id, generator_id, std::vector<int>(4, list_id));
+}
+
+/**
+ * @brief Previous ListReverser behaviour: operator[] for every access
+ */
+double
+run_map(size_t in_flight, size_t total_sets)
+{
+  std::map<int, PendingList> table;
+  auto start = std::chrono::steady_clock::now();
+  size_t completed = 0;
+  for (size_t step = 0; step < total_sets + in_flight; ++step) {
+    if (step < total_sets) {
+      int id = static_cast<int>(step);
+      if (!table.count(id)) {
+        table[id].requestor = "validator";
+        table[id].list.list_id = id;
+      }
+    }
+    if (step >= in_flight) {
+      int id = static_cast<int>(step - in_flight);
+      for (size_t gen = 0; gen < s_num_generators; ++gen) {
+        auto list = make_list(id, gen);
+        ReversedList::Data data;
+        data.original = list;
+        data.reversed = list;
+        table[id].list.lists.push_back(data);
+        if (table[id].list.lists.size() >= s_num_generators) {
+          completed += table[id].list.lists.size();
+          table.erase(id);
+        }
+      }
+    }
+  }
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  if (completed != total_sets * s_num_generators) {
+    std::cerr << "map: expected " << total_sets * s_num_generators << " lists, got " << completed << std::endl;
+  }
+  return std::chrono::duration<double, std::nano>(elapsed).count() / total_sets;
+}
+
+/**
+ * @brief Current ListReverser behaviour: one lookup per event
+ */
+double
+run_table(size_t in_flight, size_t total_sets)
+{
+  PendingListTable table(in_flight, s_num_generators);
+  auto start = std::chrono::steady_clock::now();
+  size_t completed = 0;
+  for (size_t step = 0; step < total_sets + in_flight; ++step) {
+    if (step < total_sets) {
+      auto [pending, created] = table.insert(static_cast<int>(step));
+      if (created) {
+        pending->requestor = "validator";
+      }
+    }
+    if (step >= in_flight) {
+      int id = static_cast<int>(step - in_flight);
+      for (size_t gen = 0; gen < s_num_generators; ++gen) {
+        auto list = make_list(id, gen);
+        auto pending = table.find(id);
+        auto& data = pending->add_list_from(list.generator_id, gen);
+        data.original = list;
+        data.reversed = list;
+        if (pending->received_lists >= s_num_generators) {
+          completed += pending->received_lists;
+          table.erase(id);
+        }
+      }
+    }
+  }
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  if (completed != total_sets * s_num_generators) {
+    std::cerr << "table: expected " << total_sets * s_num_generators << " lists, got " << completed << std::endl;
+  }
+  return std::chrono::duration<double, std::nano>(elapsed).count() / total_sets;
+}
+
+} // namespace
+
+int
+main(int argc, char** argv)
+{
+  size_t total_sets = 1000000;
+  if (argc > 1) {
+    total_sets = std::strtoul(argv[1], nullptr, 10);
+  }
+
+  std::cout << std::setw(10) << "in_flight" << std::setw(16) << "map ns/set" << std::setw(16) << "table ns/set"
+            << std::setw(10) << "speedup" << std::endl;
+  for (size_t in_flight : { 1000, 10000, 100000 }) {
+    auto map_ns = run_map(in_flight, total_sets);
+    auto table_ns = run_table(in_flight, total_sets);
+    std::cout << std::setw(10) << in_flight << std::setw(16) << std::fixed << std::setprecision(1) << map_ns
+              << std::setw(16) << table_ns << std::setw(10) << std::setprecision(2) << map_ns / table_ns << std::endl;
+  }
+  return 0;
+}
@@ -0,0 +1,241 @@
+/**
+ * @file shm_transport_benchmark.cxx
+ *
+ * Compare the two ways a RandomDataListGenerator can pass an IntList to a ListReverser on the same host, for list
+ * sizes from 50 to 10^6 elements. On the network path the whole list is serialized, as iomanager does, sent through
+ * a loopback TCP socket and deserialized. On the shared-memory path the list is written to a ShmListRing and only
+ * the serialized descriptor goes through the socket; the receiver copies the payload out of the ring. A sender and
+ * a receiver thread run concurrently, and every received list is checked.
+ *
+ * This is part of the DUNE DAQ Software Suite, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#include "CommonIssues.hpp"
+#include "ShmListRing.hpp"
+
+#include "serialization/Serialization.hpp"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace dunedaq::listrev;
+
+namespace {
+
+constexpr size_t s_ring_size = size_t(64) << 20;
+constexpr size_t s_total_elements = 200000000;
+
+/**
+ * @brief A connected pair of loopback TCP sockets
+ */
+struct SocketPair
+{
+  int sender{ -1 };
+  int receiver{ -1 };
+
+  SocketPair()
+  {
+    int listener = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t len = sizeof(addr);
+    if (listener < 0 || bind(listener, reinterpret_cast<sockaddr*>(&addr), len) != 0 || listen(listener, 1) != 0 ||
+        getsockname(listener, reinterpret_cast<sockaddr*>(&addr), &len) != 0) {
+      throw std::runtime_error("unable to listen on a loopback socket");
+    }
+    sender = socket(AF_INET, SOCK_STREAM, 0);
+    if (connect(sender, reinterpret_cast<sockaddr*>(&addr), len) != 0) {
+      throw std::runtime_error("unable to connect to the loopback socket");
+    }
+    receiver = accept(listener, nullptr, nullptr);
+    close(listener);
+    int one = 1;
+    setsockopt(sender, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+  }
+  ~SocketPair()
+  {
+    close(sender);
+    close(receiver);
+  }
+};
+
+void
+send_message(int fd, const std::vector<uint8_t>& bytes) // NOLINT(build/unsigned)
+{
+  uint64_t size = bytes.size(); // NOLINT(build/unsigned)
+  if (write(fd, &size, sizeof(size)) != sizeof(size)) {
+    throw std::runtime_error("short write");
+  }
+  size_t done = 0;
+  while (done < bytes.size()) {
+    auto n = write(fd, bytes.data() + done, bytes.size() - done);
+    if (n <= 0) {
+      throw std::runtime_error("write failed");
+    }
+    done += n;
+  }
+}
+
+bool
+receive_message(int fd, std::vector<uint8_t>& bytes) // NOLINT(build/unsigned)
+{
+  uint64_t size = 0; // NOLINT(build/unsigned)
+  size_t done = 0;
+  while (done < sizeof(size)) {
+    auto n = read(fd, reinterpret_cast<char*>(&size) + done, sizeof(size) - done);
+    if (n <= 0) {
+      return false;
+    }
+    done += n;
+  }
+  bytes.resize(size);
+  done = 0;
+  while (done < size) {
+    auto n = read(fd, bytes.data() + done, size - done);
+    if (n <= 0) {
+      return false;
+    }
+    done += n;
+  }
+  return true;
+}
+
+bool
+check(const IntList& list, const std::vector<int>& source, int list_id)
+{
+  return list.list_id == list_id && list.list.size() == source.size() && list.list.front() == source.front() &&
+         list.list.back() == source.back();
+}
+
+struct Result
+{
+  double ns_per_list;
+  size_t bad_lists;
+  size_t ring_full; ///< Times the sender found the ring full and had to wait
+};
+
+Result
+run_network(const std::vector<int>& source, size_t messages)
+{
+  SocketPair sockets;
+  size_t bad = 0;
+  auto start = std::chrono::steady_clock::now();
+  std::thread receiver([&] {
+    std::vector<uint8_t> bytes; // NOLINT(build/unsigned)
+    for (size_t idx = 0; idx < messages; ++idx) {
+      if (!receive_message(sockets.receiver, bytes)) {
+        bad += messages - idx;
+        return;
+      }
+      auto list = dunedaq::serialization::deserialize<IntList>(bytes);
+      bad += check(list, source, static_cast<int>(idx)) ? 0 : 1;
+    }
+  });
+  for (size_t idx = 0; idx < messages; ++idx) {
+    IntList list(static_cast<int>(idx), 0, source);
+    send_message(sockets.sender, dunedaq::serialization::serialize(list, dunedaq::serialization::kMsgPack));
+  }
+  receiver.join();
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  return Result{ std::chrono::duration<double, std::nano>(elapsed).count() / messages, bad, 0 };
+}
+
+Result
+run_shm(const std::vector<int>& source, size_t messages)
+{
+  SocketPair sockets;
+  auto ring = ShmListRing::create(ShmListRing::ring_name("shm_transport_benchmark", std::to_string(getpid())),
+                                  s_ring_size);
+  auto reader = ShmListRing::attach(ring->name());
+  size_t bad = 0;
+  size_t ring_full = 0;
+  auto start = std::chrono::steady_clock::now();
+  std::thread receiver([&] {
+    std::vector<uint8_t> bytes; // NOLINT(build/unsigned)
+    IntList list;
+    for (size_t idx = 0; idx < messages; ++idx) {
+      if (!receive_message(sockets.receiver, bytes)) {
+        bad += messages - idx;
+        return;
+      }
+      auto descriptor = dunedaq::serialization::deserialize<IntList>(bytes);
+      bad += reader->read(descriptor, list) && check(list, source, static_cast<int>(idx)) ? 0 : 1;
+    }
+  });
+  for (size_t idx = 0; idx < messages; ++idx) {
+    IntList list(static_cast<int>(idx), 0, source);
+    // No lease: every block is read, so the sender waits for the receiver instead of reclaiming
+    while (!ring->write(list, std::chrono::milliseconds(0))) {
+      ++ring_full;
+      std::this_thread::yield();
+    }
+    send_message(sockets.sender, dunedaq::serialization::serialize(list, dunedaq::serialization::kMsgPack));
+  }
+  receiver.join();
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  return Result{ std::chrono::duration<double, std::nano>(elapsed).count() / messages, bad, ring_full };
+}
+
+} // namespace
+
+int
+main(int argc, char** argv)
+{
+  size_t total_elements = s_total_elements;
+  if (argc > 1) {
+    total_elements = std::strtoul(argv[1], nullptr, 10);
+  }
+
+  std::cout << std::setw(10) << "elements" << std::setw(10) << "lists" << std::setw(17) << "network us/list"
+            << std::setw(14) << "network GB/s" << std::setw(12) << "shm us/list" << std::setw(10) << "shm GB/s"
+            << std::setw(10) << "speedup" << std::setw(11) << "ring full" << std::endl;
+  bool all_good = true;
+  for (size_t elements : { 50, 1000, 10000, 100000, 1000000 }) {
+    std::vector<int> source(elements);
+    std::iota(source.begin(), source.end(), 1);
+    auto messages = std::clamp<size_t>(total_elements / elements, 100, 200000);
+
+    Result network{};
+    Result shm{};
+    try {
+      network = run_network(source, messages);
+      shm = run_shm(source, messages);
+    } catch (const ShmRingError& excpt) {
+      std::cerr << excpt.message() << std::endl;
+      return 1;
+    } catch (const std::runtime_error& excpt) {
+      std::cerr << excpt.what() << std::endl;
+      return 1;
+    }
+    if (network.bad_lists + shm.bad_lists > 0) {
+      std::cerr << elements << " elements: " << network.bad_lists << " bad lists on the network path and "
+                << shm.bad_lists << " on the shared-memory path" << std::endl;
+      all_good = false;
+    }
+
+    auto gb_per_s = [&](double ns_per_list) { return elements * sizeof(int) / ns_per_list; };
+    std::cout << std::setw(10) << elements << std::setw(10) << messages << std::fixed << std::setprecision(2)
+              << std::setw(17) << network.ns_per_list / 1000 << std::setw(14) << gb_per_s(network.ns_per_list)
+              << std::setw(12) << shm.ns_per_list / 1000 << std::setw(10) << gb_per_s(shm.ns_per_list)
+              << std::setw(10) << network.ns_per_list / shm.ns_per_list << std::setw(11) << shm.ring_full
+              << std::endl;
+  }
+  return all_good ? 0 : 1;
+}